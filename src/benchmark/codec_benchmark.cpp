@@ -0,0 +1,96 @@
+#include <chrono>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "rpc/rpc_communication.hpp"
+#include "log/server_log.hpp"
+
+// ========== Codec benchmark ==========
+
+// This benchmark compares the binary and the JSON wire formats on the RPCs sent by the processes
+// For each RPC, it measures the time to serialize and decode the message and the size of the message
+// It can be called with : ./codec_benchmark [iterations]
+
+// Function used to measure the average time (in ns) of the given function
+template <typename Function>
+static double measure(size_t iterations, Function function)
+{
+    auto start = std::chrono::high_resolution_clock::now();
+    for (size_t i = 0; i < iterations; i++)
+    {
+        function();
+    }
+    auto end = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - start).count() / (double)iterations;
+}
+
+static void benchmark_rpc(const std::string& name, const RPC& rpc, size_t iterations)
+{
+    for (RPC::WIRE_FORMAT wire_format : {RPC::WIRE_FORMAT::JSON, RPC::WIRE_FORMAT::BINARY})
+    {
+        const std::string serialized = rpc.serialize(wire_format);
+
+        double encode_time = measure(iterations, [&]() {
+            std::string message = rpc.serialize(wire_format);
+            if (message.empty())
+                std::abort();
+        });
+        double decode_time = measure(iterations, [&]() {
+            std::optional<Query> query = decode_query(1, serialized.data(), serialized.size());
+            if (!query.has_value())
+                std::abort();
+        });
+
+        std::cout << std::left << std::setw(30) << name
+                  << std::setw(8) << (wire_format == RPC::WIRE_FORMAT::JSON ? "json" : "binary")
+                  << std::right << std::setw(10) << serialized.size() << " B"
+                  << std::setw(12) << std::fixed << std::setprecision(1) << encode_time << " ns"
+                  << std::setw(12) << decode_time << " ns" << std::endl;
+    }
+}
+
+int main(int argc, char** argv)
+{
+    size_t iterations = argc > 1 ? std::atoi(argv[1]) : 100000;
+
+    std::cout << std::left << std::setw(30) << "rpc" << std::setw(8) << "format"
+              << std::right << std::setw(12) << "size" << std::setw(15) << "encode" << std::setw(15) << "decode" << std::endl;
+
+    benchmark_rpc("Heartbeat", Heartbeat(12, 5, 1024, 11, 1020), iterations);
+    benchmark_rpc("VoteRequest", VoteRequest(12, 5, 1024, 11), iterations);
+    benchmark_rpc("VoteResponse", VoteResponse(12, true), iterations);
+    benchmark_rpc("AppendEntriesResponse", AppendEntriesResponse(12, true, 1024), iterations);
+    benchmark_rpc("NewLogEntry", NewLogEntry(1, {LogEntryView(-1, "static log 1_1 with some payload")}), iterations);
+    benchmark_rpc("SearchLeader", SearchLeader(0), iterations);
+    benchmark_rpc("Message", Message(Message::MESSAGE_TYPE::CLIENT_CREATE_NEW_ENTRY, "testing a new log entry"), iterations);
+
+    // AppendEntries with a growing number of entries (the suffix sent to a follower)
+    for (size_t entries_count : {1, 16, 256})
+    {
+        std::vector<LogEntry> entries;
+        for (size_t i = 0; i < entries_count; i++)
+        {
+            entries.emplace_back(12, "static log " + std::to_string(i) + " with some payload");
+        }
+        std::vector<LogEntryView> entries_views(entries.begin(), entries.end());
+        benchmark_rpc("AppendEntries[" + std::to_string(entries_count) + "]", AppendEntries(12, 5, 1024, 11, entries_views, 1020),
+                      std::max<size_t>(iterations / entries_count, 1));
+        // Same entries batched by a client
+        benchmark_rpc("NewLogEntry[" + std::to_string(entries_count) + "]", NewLogEntry(1, entries_views),
+                      std::max<size_t>(iterations / entries_count, 1));
+
+        // Same entries but encoded once in the logs, as it is done by the leader
+        ServerLog logs;
+        for (const LogEntry& entry : entries)
+        {
+            logs.append(entry);
+        }
+        benchmark_rpc("AppendEntries[" + std::to_string(entries_count) + "] cached", AppendEntries(12, 5, 1024, 11, logs.encoded_entries(0), entries_count, 1020),
+                      std::max<size_t>(iterations / entries_count, 1));
+    }
+
+    return 0;
+}
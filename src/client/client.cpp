@@ -1,17 +1,46 @@
 #include "client.hpp"
 
+#include <climits>
+#include <random>
+
 // Include the file where all the communication functions are
 #include "rpc/rpc_communication.hpp"
 
+// Prefix of the commands that are read from the state machine of the servers instead of being added to the logs
+static const std::string READ_PREFIX = "READ ";
+// Prefix of the reads that can be answered by a follower with a state older than the last committed entries (with the follower reads)
+static const std::string STALE_READ_PREFIX = "STALE_READ ";
+
+// Function used to get the size of the prefix of the command if it is a read (0 if the command is not a read)
+static size_t read_prefix_size(const std::string& command)
+{
+    if (command.compare(0, READ_PREFIX.size(), READ_PREFIX) == 0)
+    {
+        return READ_PREFIX.size();
+    }
+    return command.compare(0, STALE_READ_PREFIX.size(), STALE_READ_PREFIX) == 0 ? STALE_READ_PREFIX.size() : 0;
+}
+
+// Function used to draw the id of a new session (0 is the id of the entries without session)
+static int new_session_id()
+{
+    std::random_device random_device;
+    return std::uniform_int_distribution<int>(1, INT_MAX)(random_device);
+}
+
 // ========== Constructor function ==========
 
-Client::Client(int rank, int server_count, int client_count) :
+Client::Client(int rank, int server_count, int client_count, const ClientConfig& config) :
     _rank(rank),
     _is_stopped(false),
     _leader_rank(0),
+    _config(config),
     _entries_to_send(),
-    _entry_sent(true),
-    _entry_clock(),
+    _outstanding_entries(),
+    _next_request_id(1),
+    _session_id(new_session_id()),
+    _next_sequence(1),
+    _next_read_server(rank),
     _client_count(client_count),
     _server_count(server_count),
     _has_started(false)
@@ -23,9 +52,8 @@ Client::Client(int rank, int server_count, int client_count) :
     // Setting the timeout as 100
     this->_timeout = 100;
 
-    // Setting up the two clocks of the client
+    // Setting up the clock of the client
     this->_leader_clock = Clock();
-    this->_entry_clock = Clock();
 
     // Creating the log path of the server
     this->_commands_filepath = "client_commands/commands_client_" + std::to_string(rank) + ".txt";
@@ -60,7 +88,7 @@ void Client::parse_commands_file()
     {
         for (std::string line; std::getline(commands_file, line);)
         {
-            this->_entries_to_send.emplace(LogEntry(-1, line));
+            this->_entries_to_send.emplace(-1, line);
         }
     }
 }
@@ -74,7 +102,7 @@ void Client::parse_new_command_file(std::string filename)
     {
         for (std::string line; std::getline(commands_file, line);)
         {
-            this->_entries_to_send.emplace(LogEntry(-1, line));
+            this->_entries_to_send.emplace(-1, line);
         }
     }
 }
@@ -97,32 +125,62 @@ void Client::handle_queries(const std::vector<Query>& queries)
             {
                 const SearchLeaderResponse& leader_response = std::get<SearchLeaderResponse>(query._content);
                 // If we don't already have a leader, then set the new leader's rank
-                if (this->_leader_rank == 0)
+                // The followers also answer with the leader they know, so the answer of the leader itself replaces theirs
+                if (this->_leader_rank == 0 || (int)query._source_rank == leader_response._leader_rank)
                 {
                     this->_leader_rank = leader_response._leader_rank;
                     this->_leader_clock.reset();
-                    // Also reset the entry timeout to make sure that it won't reset the leader instantly
-                    this->_entry_clock.reset();
+                }
+                break;
+            }
+            case RPC::RPC_TYPE::READ_RESPONSE:
+            {
+                const ReadResponse& read_response = std::get<ReadResponse>(query._content);
+                // The responses of the reads that are already answered are ignored (the read may have been sent several times)
+                auto outstanding_entry = this->_outstanding_entries.find(read_response._request_id);
+                if (outstanding_entry == this->_outstanding_entries.end())
+                {
+                    break;
+                }
+                // The result of the read is printed once it is answered, the query is sent again otherwise
+                if (read_response._success)
+                {
+                    const std::string& command = outstanding_entry->second._entries.front()._command;
+                    std::cout << "Client " << this->_rank << " read " << command.substr(read_prefix_size(command)) 
+                              << " : " << read_response._result << std::endl;
+                    this->_outstanding_entries.erase(outstanding_entry);
+                }
+                else
+                {
+                    this->entry_failed(outstanding_entry->second, read_response._leader_hint);
                 }
                 break;
             }
             case RPC::RPC_TYPE::NEW_LOG_ENTRY_RESPONSE:
             {
                 const NewLogEntryResponse& entriesResponse = std::get<NewLogEntryResponse>(query._content);
-                // Checking if the new log entries has been received correctly
+                // The responses of the entries that are already answered are ignored (the entry may have been sent several times)
+                auto outstanding_entry = this->_outstanding_entries.find(entriesResponse._request_id);
+                if (outstanding_entry == this->_outstanding_entries.end())
+                {
+                    break;
+                }
+                // Checking if the new log entries has been received correctly, it is sent again otherwise
+                // The entries forwarded by a follower are answered with the leader as a hint, which is kept if the client does not know the leader
                 if (entriesResponse._success)
                 {
-                    this->_entries_to_send.pop();
+                    this->_outstanding_entries.erase(outstanding_entry);
+                    if (this->_leader_rank == 0 && entriesResponse._leader_hint != 0)
+                    {
+                        this->_leader_rank = entriesResponse._leader_hint;
+                        this->_leader_clock.reset();
+                    }
                 }
-                // If not and the leader is not set up, then reset it
-                else if (this->_leader_rank != 0)
+                else
                 {
-                    this->_leader_rank = 0;
-                    this->_leader_clock.reset();
+                    outstanding_entry->second._destination_rank = 0;
+                    this->entry_failed(outstanding_entry->second, entriesResponse._leader_hint);
                 }
-                // Set up the entries as sent 
-                this->_entry_sent = true;
-                this->_entry_clock.reset();
                 break;
             }
             default:
@@ -145,7 +203,7 @@ void Client::handle_message(const Query& query)
         {
             // Setting up the term as -1 as this will come from a client so it wont have a term
             // std::cout << "Client " << this->_rank << " received and added new entry." << std::endl;
-            this->_entries_to_send.emplace(NewLogEntry(LogEntry(-1, message._content)));
+            this->_entries_to_send.emplace(-1, message._content);
             break;
         }
         case Message::MESSAGE_TYPE::CLIENT_NEW_FILE_ENTRY:
@@ -201,7 +259,6 @@ void Client::handle_message(const Query& query)
                 // Init again just in case 
                 this->_leader_rank = 0;
                 this->_leader_clock.reset();
-                this->_entry_clock.reset();
             }
             else 
             {                
@@ -215,10 +272,13 @@ void Client::handle_message(const Query& query)
             if (this->_status == ClientStatus::RUNNING)
             {
                 this->_status = ClientStatus::DEAD;
-                // Reseting the variables 
+                // Reseting the variables (the entries waiting for their response are sent again once the client recovers)
                 this->_leader_rank = 0;
                 this->_leader_clock.reset();
-                this->_entry_clock.reset();
+                for (auto& [request_id, outstanding_entry] : this->_outstanding_entries)
+                {
+                    outstanding_entry._sent = false;
+                }
             }
             else 
             {
@@ -257,59 +317,226 @@ void Client::update()
 {
     // Handle queries
     std::vector<Query> received_queries;
-    // For the clients, as they can reveice queries from the controler, clients or servers, we receive from all the possible ranks
-    receive_all_messages(this->_rank, (this->_server_count + this->_client_count + 1), 0, received_queries, 0);
+    // For the clients, as they can reveice queries from the controler, clients or servers, we receive from any rank
+    receive_all_messages(received_queries, 0, this->_config.receive_budget);
     this->handle_queries(received_queries);
 
     if (this->_status != ClientStatus::DEAD)
     {
-        // Search for leader or send next entry
-        if (this->_leader_rank == 0)
+        // The entries that are not answered in time are sent again (to the new leader)
+        for (auto& [request_id, outstanding_entry] : this->_outstanding_entries)
         {
-            // Check if the client has timeout
-            if (this->_leader_clock.check() > this->_timeout) 
+            if (outstanding_entry._sent && outstanding_entry._clock.check() > this->_timeout)
             {
-                // Creating the query to get the leader and sending it to all the servers
-                SearchLeader searchLeader = SearchLeader(this->_leader_rank);
-                send_to_all_processes(this->_rank, this->_server_count, this->_client_count + 1, searchLeader, 0);
-                this->_leader_clock.reset();
+                this->entry_failed(outstanding_entry);
             }
         }
-        // If we have a valid leader, then send the next entry if there are to send
-        else if (this->_entry_sent && !(this->_entries_to_send.empty()))
+
+        // Search for leader if it is not known
+        if (this->_leader_rank == 0 && this->_leader_clock.check() > this->_timeout)
         {
-            // Getting the next entry to send
-            const NewLogEntry& newLogEntry = this->_entries_to_send.front();
-            send_message(newLogEntry, this->_leader_rank, 0);
-            // Reseting the clock for entries and the verification 
-            this->_entry_sent = false;
-            this->_entry_clock.reset();
+            // Creating the query to get the leader and sending it to all the servers
+            SearchLeader searchLeader = SearchLeader(this->_leader_rank);
+            send_to_all_processes(this->_rank, this->_server_count, this->_client_count + 1, searchLeader, 0);
+            this->_leader_clock.reset();
         }
 
-        // Check if the new log entry has been sent correctly
-        if (!this->_entry_sent && !(this->_entries_to_send.empty()))
+        // Sending again the entries that failed (in the order of the request ids), then the next entries as long as the window is not full
+        for (auto& [request_id, outstanding_entry] : this->_outstanding_entries)
         {
-            if (this->_entry_clock.check() > this->_timeout)
+            if (!outstanding_entry._sent)
             {
-                // If the entry response took too much time to come, set it as sent to make the new leader get it again
-                this->_entry_sent = true;
-                // Then if the leader is not set, reset him
-                if (this->_leader_rank != 0)
-                {
-                    this->_leader_rank = 0;
-                    this->_leader_clock.reset();
-                    this->_entry_clock.reset();
-                }
+                this->send_entry(request_id, outstanding_entry);
+            }
+        }
+        while (this->can_start_batch())
+        {
+            const int request_id = this->_next_request_id++;
+            auto outstanding_entry = this->_outstanding_entries.emplace(request_id, OutstandingEntry{this->next_batch(), false, Clock(), 0});
+            this->send_entry(request_id, outstanding_entry.first->second);
+        }
+    }
+}
+
+bool Client::can_start_batch() const
+{
+    if ((int)this->_outstanding_entries.size() >= this->_config.client_window || this->_entries_to_send.empty())
+    {
+        return false;
+    }
+    // A read is only sent once the entries before it are answered, and the entries after it once it is answered
+    // This way, the reads see all the previous entries of the client and none of the following ones, as without the window
+    return this->_outstanding_entries.empty()
+           || (read_prefix_size(this->_entries_to_send.front()._command) == 0
+               && read_prefix_size(this->_outstanding_entries.rbegin()->second._entries.front()._command) == 0);
+}
+
+std::vector<LogEntry> Client::next_batch()
+{
+    std::vector<LogEntry> batch;
+    size_t batch_bytes = 0;
+    while (!this->_entries_to_send.empty() && (int)batch.size() < this->_config.batch_entries)
+    {
+        // The reads are not added to the logs, so they are sent alone and end the current batch
+        const LogEntry& entry = this->_entries_to_send.front();
+        const bool read = read_prefix_size(entry._command) > 0;
+        if (!batch.empty() && (read || batch_bytes + entry._command.size() > (size_t)this->_config.batch_bytes))
+        {
+            break;
+        }
+        batch_bytes += entry._command.size();
+        batch.push_back(std::move(this->_entries_to_send.front()));
+        this->_entries_to_send.pop();
+        // The entries of the logs get the next sequence number of the session of the client, which is kept when they are sent again
+        if (!read)
+        {
+            batch.back()._client_id = this->_session_id;
+            batch.back()._sequence = this->_next_sequence++;
+        }
+        if (read)
+        {
+            break;
+        }
+    }
+    return batch;
+}
+
+int Client::answered_sequence() const
+{
+    // The sequence numbers of the batches increase with their request id (the reads have no sequence number)
+    for (const auto& [request_id, outstanding_entry] : this->_outstanding_entries)
+    {
+        if (outstanding_entry._entries.front()._sequence > 0)
+        {
+            return outstanding_entry._entries.front()._sequence;
+        }
+    }
+    return this->_next_sequence;
+}
+
+bool Client::is_follower_read(const LogEntry& entry) const
+{
+    return this->_config.follower_reads && read_prefix_size(entry._command) > 0;
+}
+
+bool Client::can_send(const LogEntry& entry) const
+{
+    // The entries (and the reads without the follower reads) are only sent once the leader is known
+    // If the proposals are forwarded, the entries are sent to any server in turn while it is not known (the followers forward them to the leader)
+    return this->_leader_rank != 0 || this->is_follower_read(entry) || (this->_config.forward_proposals && read_prefix_size(entry._command) == 0);
+}
+
+void Client::send_entry(int request_id, OutstandingEntry& outstanding_entry)
+{
+    if (!this->can_send(outstanding_entry._entries.front()))
+    {
+        return;
+    }
+
+    // The commands starting with READ are queries read from the state machine, they are not added to the logs
+    const std::string& command = outstanding_entry._entries.front()._command;
+    const size_t prefix_size = read_prefix_size(command);
+    const bool follower_read = this->is_follower_read(outstanding_entry._entries.front());
+    if (prefix_size > 0)
+    {
+        const bool stale = command.compare(0, STALE_READ_PREFIX.size(), STALE_READ_PREFIX) == 0;
+        const ReadRequest readRequest = ReadRequest(request_id, std::string_view(command).substr(prefix_size), stale);
+        size_t destination_rank = this->_leader_rank;
+        if (follower_read)
+        {
+            destination_rank = this->_client_count + 1 + this->_next_read_server % this->_server_count;
+            this->_next_read_server++;
+        }
+        send_message(readRequest, destination_rank, 0);
+    }
+    else
+    {
+        // The entries are sent as views on the ones of the batch, which is kept until it is answered
+        // The entries before the first waiting one were all answered, so the servers can remove their results from the session
+        std::vector<LogEntryView> entries(outstanding_entry._entries.begin(), outstanding_entry._entries.end());
+        const int answered_sequence = this->answered_sequence();
+        for (LogEntryView& entry : entries)
+        {
+            entry._answered_sequence = answered_sequence;
+        }
+        const NewLogEntry newLogEntry = NewLogEntry(request_id, std::move(entries));
+        size_t destination_rank = this->_leader_rank;
+        if (destination_rank == 0)
+        {
+            if (outstanding_entry._destination_rank == 0)
+            {
+                outstanding_entry._destination_rank = this->_client_count + 1 + this->_next_read_server % this->_server_count;
+                this->_next_read_server++;
             }
+            destination_rank = outstanding_entry._destination_rank;
         }
+        send_message(newLogEntry, destination_rank, 0);
+    }
+    outstanding_entry._sent = true;
+    outstanding_entry._clock.reset();
+}
+
+void Client::entry_failed(OutstandingEntry& outstanding_entry, int leader_hint)
+{
+    // The entry is sent again with the next update (the follower reads are sent again to the next server)
+    outstanding_entry._sent = false;
+    if (this->is_follower_read(outstanding_entry._entries.front()))
+    {
+        return;
+    }
+    // Otherwise, the leader may have changed : it is the hint of the server that denied the entry if it knows it, it is searched again otherwise
+    if (leader_hint != 0)
+    {
+        this->_leader_rank = leader_hint;
+        this->_leader_clock.reset();
+    }
+    else if (this->_leader_rank != 0)
+    {
+        this->_leader_rank = 0;
+        this->_leader_clock.reset();
+    }
+}
+
+float Client::next_timeout()
+{
+    float timeout = this->_timeout;
+    if (this->_status == ClientStatus::DEAD)
+    {
+        return timeout;
+    }
+
+    // The client does not wait if it has entries to send
+    for (auto& [request_id, outstanding_entry] : this->_outstanding_entries)
+    {
+        if (!outstanding_entry._sent && this->can_send(outstanding_entry._entries.front()))
+        {
+            return 0;
+        }
+        if (outstanding_entry._sent)
+        {
+            timeout = std::min(timeout, this->_timeout - outstanding_entry._clock.check());
+        }
+    }
+    if (this->can_start_batch() && this->can_send(this->_entries_to_send.front()))
+    {
+        return 0;
+    }
+
+    // Otherwise, it waits for the responses until the first entry that is not answered in time, or until the next leader search
+    if (this->_leader_rank == 0)
+    {
+        timeout = std::min(timeout, this->_timeout - this->_leader_clock.check());
     }
+    return std::max(timeout, 0.0f);
 }
 
 void Client::run_client()
 {
     while (!this->_is_stopped)
     {
-        // Waiting depending on the speed of the client
+        // Waiting for the next message or the next timer, whichever comes first
+        wait_for_message(0, this->next_timeout(), this->_config.busy_poll ? 0 : this->_config.poll_interval);
+        // Waiting depending on the speed of the client (the delay is injected before handling the message or the timer)
         Clock::wait((int)this->_client_speed);
 
         // Updating the client (handling the queries, leader search, timeout...)
@@ -12,6 +12,7 @@
 #include <queue>
 
 #include "clock/clock.hpp"
+#include "client/client_config.hpp"
 #include "message/message.hpp"
 #include "rpc/query/query.hpp"
 #include "rpc/entries/append_entries.hpp"
@@ -22,7 +23,7 @@ enum class ClientStatus { RUNNING, DEAD };
 
 enum class Speed 
 {
-    // The speed is linked to the delay that the client will wait before each update
+    // The speed is linked to the delay that the client will wait before each update (once a message arrived or a timer is over)
     // So the more the server is fast, the less the delay is high
     HIGH = 0,
     MEDIUM = 250,
@@ -32,7 +33,7 @@ enum class Speed
 class Client
 {
 public:
-    Client(int rank, int client_count, int server_count);
+    Client(int rank, int client_count, int server_count, const ClientConfig& config);
 
     // Run functions
     void run_client();
@@ -48,9 +49,39 @@ private:
     // Queries handling functions
     void handle_message(const Query& query);
     void handle_queries(const std::vector<Query>& queries);
+
+    // Batch of entries sent by the client in a single request and waiting for its response
+    struct OutstandingEntry
+    {
+        // Entries of the batch, in the order of the commands (a read is always alone in its batch)
+        std::vector<LogEntry> _entries;
+        // False if the entry must be sent (again) to the servers
+        bool _sent;
+        // Clock started when the entry was sent, the entry is sent again if it is not answered in time
+        Clock _clock;
+        // Server to which the entry is sent while the leader is not known (0 if it is not chosen yet), with the forwarded proposals
+        // The entry is sent again to the same server until it is denied, so that it is not forwarded to the leader by several servers
+        size_t _destination_rank;
+    };
+    // Function used to know if a new batch can be taken from the queue (the window is not full and no read is waiting)
+    bool can_start_batch() const;
+    // Function used to take the next batch of entries to send from the queue (consecutive entries up to the batch limits, or a single read)
+    std::vector<LogEntry> next_batch();
+    // Functions used to send a batch of entries (or a read) to the servers, and to send it again once it failed
+    void send_entry(int request_id, OutstandingEntry& outstanding_entry);
+    // The leader hint is the leader known by the server that denied the entry (0 if it is unknown or if the entry was not answered in time)
+    void entry_failed(OutstandingEntry& outstanding_entry, int leader_hint = 0);
+    // Function used to get the sequence number of the first entry waiting for its response (all the entries before it were answered)
+    int answered_sequence() const;
+    // Function used to know if the entry is a read sent to any server (with the follower reads), instead of the leader
+    bool is_follower_read(const LogEntry& entry) const;
+    // Function used to know if the entry can be sent now (the leader is known, or the entry can be sent to any server)
+    bool can_send(const LogEntry& entry) const;
     
     // Update function to update the client status
     void update(); 
+    // Function used to get the time (in milliseconds) until the next timer of the client, the client waits for a message until then
+    float next_timeout();
     
     // ===== Client class privates variables =====
 
@@ -73,12 +104,24 @@ private:
     // Clock to detect the timeout (to run servers leader search queries)
     Clock _leader_clock;
   
+    // Options of the client
+    ClientConfig _config;
+  
     // Queue of the entries to send to the servers leader
-    std::queue<NewLogEntry> _entries_to_send;
-    // To dertermine if the next entry in the queue is commited to the leader
-    bool _entry_sent;
-    // Entry clock, used to check if the leader is dead
-    Clock _entry_clock;
+    std::queue<LogEntry> _entries_to_send;
+    // Batches sent and waiting for their response, by request id (at most client window batches)
+    // The batches are sent again in the order of their request id if they failed
+    std::map<int, OutstandingEntry> _outstanding_entries;
+    // Request id of the next entry sent by the client
+    int _next_request_id;
+    // Id of the session of the client, drawn randomly when the client is created (a client restarted with the same rank starts a new session)
+    // and sequence number of the next entry added to the logs by the client
+    // Each entry keeps its sequence number when it is sent again, so the servers apply it only once (see SessionStateMachine)
+    int _session_id;
+    int _next_sequence;
+
+    // Index of the next server to which a read is sent with the follower reads (or a new entry while the leader is not known, with the forwarded proposals)
+    size_t _next_read_server;
 
     // Server and client counts to determine the range of their ranks for the communication
     size_t _client_count;
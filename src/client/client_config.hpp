@@ -0,0 +1,24 @@
+#pragma once
+
+// ========== ClientConfig struct ==========
+
+// Options of the clients, given with the arguments of the program (see main.cpp)
+struct ClientConfig
+{
+    // Maximum number of entries sent by a client and not answered yet
+    // The entries are matched with their responses by their request id, so the responses can come in any order
+    int client_window = 1;
+    // Maximum number of entries and of bytes of commands sent in a single NewLogEntry (a batch has at least one entry)
+    // The leader appends the whole batch to its logs at once, and answers it with the results of all its entries
+    int batch_entries = 1;
+    int batch_bytes = 64 * 1024;
+    // If true, the reads are sent to all the servers in turn instead of the leader (the followers also answer them)
+    bool follower_reads = false;
+    // If true, the entries are sent to any server in turn while the leader is not known, as the followers forward them to the leader
+    bool forward_proposals = false;
+    // If true, the client waits for the messages by probing them again without sleeping, otherwise it sleeps the poll interval between two probes (same as the servers)
+    bool busy_poll = false;
+    int poll_interval = 50;
+    // Maximum number of messages received by the client in an update (same as the servers)
+    int receive_budget = 1024;
+};
@@ -11,6 +11,11 @@ float Clock::check()
     return std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::high_resolution_clock::now() - this->_start_time).count();
 }
 
+float Clock::check_microseconds()
+{
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::high_resolution_clock::now() - this->_start_time).count();
+}
+
 void Clock::reset()
 {
     this->_start_time = std::chrono::high_resolution_clock::now();
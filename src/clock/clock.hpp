@@ -10,6 +10,8 @@ public:
 
     // Function used to check the elapesd time in milliseconds since the reset of the clock
     float check();
+    // Same as check but in microseconds (used for the small delays, such as the batch window of the servers)
+    float check_microseconds();
     // Function used to reset the time of the clock
     void reset();
     // Function used to wait for a certains amount of milliseconds
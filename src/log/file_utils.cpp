@@ -0,0 +1,90 @@
+#include "file_utils.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <unistd.h>
+
+// ========== File functions implementation ==========
+
+std::string read_file(const std::string& filepath)
+{
+    std::ifstream file(filepath, std::ios::binary | std::ios::ate);
+    if (!file.good())
+    {
+        return std::string();
+    }
+    std::string content(file.tellg(), '\0');
+    file.seekg(0);
+    file.read(content.data(), content.size());
+    return content;
+}
+
+std::string read_file_part(const std::string& filepath, size_t offset, size_t size)
+{
+    std::ifstream file(filepath, std::ios::binary);
+    if (!file.good())
+    {
+        return std::string();
+    }
+    std::string content(size, '\0');
+    file.seekg(offset);
+    file.read(content.data(), content.size());
+    content.resize(file.gcount());
+    return content;
+}
+
+bool write_all(int fd, const char* data, size_t size)
+{
+    size_t written = 0;
+    while (written < size)
+    {
+        const ssize_t result = write(fd, data + written, size - written);
+        if (result < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            return false;
+        }
+        written += result;
+    }
+    return true;
+}
+
+bool write_file_atomically(const std::string& filepath, const std::string& content)
+{
+    const std::string temporary_filepath = filepath + ".tmp";
+    const int fd = open(temporary_filepath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        std::cerr << "Unable to open file : " << temporary_filepath << " (" << std::strerror(errno) << ")" << std::endl;
+        return false;
+    }
+
+    const bool synced = write_all(fd, content.data(), content.size()) && fdatasync(fd) == 0;
+    close(fd);
+
+    if (!synced || std::rename(temporary_filepath.c_str(), filepath.c_str()) != 0)
+    {
+        std::cerr << "Unable to write file : " << filepath << " (" << std::strerror(errno) << ")" << std::endl;
+        return false;
+    }
+    sync_directory(std::filesystem::path(filepath).parent_path().string());
+    return true;
+}
+
+void sync_directory(const std::string& directory)
+{
+    const int directory_fd = open(directory.empty() ? "." : directory.c_str(), O_RDONLY | O_DIRECTORY);
+    if (directory_fd >= 0)
+    {
+        fsync(directory_fd);
+        close(directory_fd);
+    }
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <cstddef>
+#include <string>
+
+// ========== File functions ==========
+
+// Functions used by the stores of the servers to read and write their files
+
+// Function used to read a whole file with a single read (the content is empty if the file can not be opened)
+std::string read_file(const std::string& filepath);
+// Function used to read a part of a file, at most size bytes from the given offset (the content is shorter if the file ends before)
+std::string read_file_part(const std::string& filepath, size_t offset, size_t size);
+
+// Function used to write all the given data in the file (the write may be partial, so it is done until everything is written)
+bool write_all(int fd, const char* data, size_t size);
+
+// Function used to replace the content of a file so that the file always holds either the old or the new content, even after a crash
+// The content is written in a temporary file which is synced and then renamed, and the directory is synced to make the rename durable
+// Returns true once the new content is durable
+bool write_file_atomically(const std::string& filepath, const std::string& content);
+
+// Function used to sync a directory (to make the creation, the rename or the removal of its files durable)
+void sync_directory(const std::string& directory);
@@ -0,0 +1,62 @@
+#include "metadata_store.hpp"
+
+#include <cstdio>
+#include <stdexcept>
+
+#include "log/file_utils.hpp"
+#include "log/write_ahead_log.hpp"
+#include "rpc/codec/binary_codec.hpp"
+
+// ========== MetadataStore class implementation ==========
+
+MetadataStore::MetadataStore(const std::string& filepath)
+    : _filepath(filepath)
+{}
+
+bool MetadataStore::load(Metadata& metadata) const
+{
+    const std::string data = read_file(this->_filepath);
+
+    try
+    {
+        BinaryReader reader = BinaryReader(data.data(), data.size());
+        if (reader.read_uint32() != METADATA_MAGIC)
+        {
+            return false;
+        }
+        Metadata loaded_metadata;
+        loaded_metadata._current_term = reader.read_int32();
+        loaded_metadata._voted_for = reader.read_uint32();
+        loaded_metadata._commit_index = reader.read_int32();
+
+        const size_t checked_size = data.size() - reader.remaining();
+        if (reader.read_uint32() != WriteAheadLog::crc32(data.data(), checked_size))
+        {
+            return false;
+        }
+        metadata = loaded_metadata;
+        return true;
+    }
+    catch (const std::out_of_range&)
+    {
+        return false;
+    }
+}
+
+bool MetadataStore::store(const Metadata& metadata)
+{
+    std::string data;
+    BinaryWriter writer = BinaryWriter(data);
+    writer.write_uint32(METADATA_MAGIC);
+    writer.write_int32(metadata._current_term);
+    writer.write_uint32(metadata._voted_for);
+    writer.write_int32(metadata._commit_index);
+    writer.write_uint32(WriteAheadLog::crc32(data.data(), data.size()));
+
+    return write_file_atomically(this->_filepath, data);
+}
+
+void MetadataStore::clear()
+{
+    std::remove(this->_filepath.c_str());
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+// ========== MetadataStore class ==========
+
+// Store of the metadata of a server that must survive a crash (its term, its vote and its commit index)
+// The metadata are written in a temporary file which is synced and then renamed, so the file always holds a complete version of them
+//
+// The file has the following binary format (written in the byte order of the host, as the RPCs) :
+//  - uint32 : magic number of the metadata
+//  - int32  : current term
+//  - uint32 : rank of the server voted for in the current term (0 if there is none)
+//  - int32  : commit index
+//  - uint32 : CRC32 of the previous fields
+class MetadataStore
+{
+public:
+    struct Metadata
+    {
+        int _current_term = 0;
+        size_t _voted_for = 0;
+        int _commit_index = -1;
+    };
+
+    // Magic number written at the start of the file
+    static const uint32_t METADATA_MAGIC = 0x4D455441;
+
+    MetadataStore(const std::string& filepath);
+
+    // Function used to read the metadata from the file
+    // Returns false if there is no file or if it is not valid (the metadata are then not changed)
+    bool load(Metadata& metadata) const;
+    // Function used to replace the metadata of the file (the new metadata are durable when it returns true)
+    bool store(const Metadata& metadata);
+    // Function used to remove the file (when the server is starting without restoring its state)
+    void clear();
+
+private:
+    // Filepath of the metadata
+    std::string _filepath;
+};
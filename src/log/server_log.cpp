@@ -0,0 +1,160 @@
+#include "server_log.hpp"
+
+#include <algorithm>
+#include <stdexcept>
+
+// ========== ServerLog class implementation ==========
+
+ServerLog::ServerLog()
+    : _first_index(0), _snapshot_term(-1), _records(), _arena()
+{}
+
+void ServerLog::append(int term, std::string_view command)
+{
+    this->append(LogEntryView(term, command));
+}
+
+void ServerLog::append(const LogEntryView& entry_view)
+{
+    const size_t offset = this->_arena.size();
+    BinaryWriter writer = BinaryWriter(this->_arena);
+    entry_view.serialize_content(writer);
+    this->_records.push_back(Record{entry_view._term, (uint32_t)(this->_arena.size() - offset), offset});
+}
+
+void ServerLog::append(int term, const std::vector<LogEntryView>& entries)
+{
+    size_t batch_size = 0;
+    for (const LogEntryView& entry : entries)
+    {
+        batch_size += ENTRY_HEADER_SIZE + entry._command.size();
+    }
+    // The capacity is at least doubled, so that reserving for each batch does not copy the logs each time
+    if (this->_records.size() + entries.size() > this->_records.capacity())
+    {
+        this->_records.reserve(std::max(2 * this->_records.capacity(), this->_records.size() + entries.size()));
+    }
+    if (this->_arena.size() + batch_size > this->_arena.capacity())
+    {
+        this->_arena.reserve(std::max(2 * this->_arena.capacity(), this->_arena.size() + batch_size));
+    }
+
+    for (const LogEntryView& entry : entries)
+    {
+        this->append(LogEntryView(term, entry._command, entry._client_id, entry._sequence, entry._answered_sequence));
+    }
+}
+
+LogEntryView ServerLog::at(size_t index) const
+{
+    if (index < this->_first_index)
+    {
+        throw std::out_of_range("The log entry was removed by a snapshot");
+    }
+    const Record& record = this->_records.at(index - this->_first_index);
+    BinaryReader reader = BinaryReader(this->_arena.data() + record._offset, record._size);
+    return LogEntryView(reader);
+}
+
+LogEntryView ServerLog::back() const
+{
+    return this->at(this->size() - 1);
+}
+
+size_t ServerLog::encoded_offset(size_t position) const
+{
+    return position < this->_records.size() ? this->_records.at(position)._offset : this->_arena.size();
+}
+
+size_t ServerLog::size() const
+{
+    return this->_first_index + this->_records.size();
+}
+
+bool ServerLog::empty() const
+{
+    return this->size() == 0;
+}
+
+size_t ServerLog::first_index() const
+{
+    return this->_first_index;
+}
+
+int ServerLog::term_at(int index) const
+{
+    if (index >= (int)this->_first_index && index < (int)this->size())
+    {
+        return this->_records.at(index - this->_first_index)._term;
+    }
+    return index == (int)this->_first_index - 1 ? this->_snapshot_term : -1;
+}
+
+int ServerLog::last_term() const
+{
+    return this->term_at((int)this->size() - 1);
+}
+
+void ServerLog::compact(size_t last_included_index)
+{
+    if (last_included_index < this->_first_index || last_included_index >= this->size())
+    {
+        return;
+    }
+    const size_t removed_count = last_included_index + 1 - this->_first_index;
+    this->_snapshot_term = this->term_at(last_included_index);
+
+    // Removing the encodings of the entries and moving the offsets of the other ones
+    const size_t removed_size = this->encoded_offset(removed_count);
+    this->_arena.erase(0, removed_size);
+    this->_records.erase(this->_records.begin(), this->_records.begin() + removed_count);
+    for (Record& record : this->_records)
+    {
+        record._offset -= removed_size;
+    }
+    this->_first_index = last_included_index + 1;
+}
+
+void ServerLog::reset(size_t last_included_index, int last_included_term)
+{
+    this->_records.clear();
+    this->_arena.clear();
+    this->_first_index = last_included_index + 1;
+    this->_snapshot_term = last_included_term;
+}
+
+int ServerLog::last_index_until_term(int term) const
+{
+    auto after = std::upper_bound(this->_records.begin(), this->_records.end(), term, 
+                                  [](int term, const Record& record) { return term < record._term; });
+    return (int)(after - this->_records.begin() + this->_first_index) - 1;
+}
+
+std::string_view ServerLog::encoded_entries(size_t from) const
+{
+    return this->encoded_entries(from, this->size());
+}
+
+std::string_view ServerLog::encoded_entries(size_t from, size_t to) const
+{
+    if (from < this->_first_index || from >= to || from >= this->size())
+    {
+        return std::string_view();
+    }
+    from -= this->_first_index;
+    to -= this->_first_index;
+    const size_t start = this->encoded_offset(from);
+    return std::string_view(this->_arena.data() + start, this->encoded_offset(to) - start);
+}
+
+void ServerLog::truncate(size_t index)
+{
+    if (index < this->_first_index || index >= this->size())
+    {
+        return;
+    }
+    // Removing the encodings of the entries from the given one (the encodings before it do not move)
+    const size_t position = index - this->_first_index;
+    this->_arena.resize(this->encoded_offset(position));
+    this->_records.resize(position);
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "rpc/entries/log_entry.hpp"
+
+// ========== ServerLog class ==========
+
+// Logs of a server (the first index is 0)
+// The entries before the first index of the logs were removed by a snapshot, only the term of the last of them is kept
+// All the indexes used by the functions are the indexes in the whole logs (with the removed entries)
+// Each entry is encoded in the binary format once, when it is appended, and the encodings are kept one after the other in an arena
+// This way, the AppendEntries sent to the followers are built by copying the encodings instead of serializing the entries again
+// The entries are small records pointing to their encoding, so appending, truncating or slicing the logs does not allocate each entry
+class ServerLog
+{
+public:
+    ServerLog();
+
+    // Functions used to add an entry at the end of the logs (the command is copied in the arena)
+    void append(int term, std::string_view command);
+    void append(const LogEntryView& entry_view);
+    // Function used to add a batch of commands at the end of the logs, all with the given term
+    // The records and the arena are grown once for the whole batch
+    void append(int term, const std::vector<LogEntryView>& entries);
+
+    // Access to the entries of the logs (at throws an std::out_of_range if the entry was removed by a snapshot)
+    // The command of the entries is a view in the arena, so it is only valid until the logs are modified
+    LogEntryView at(size_t index) const;
+    LogEntryView back() const;
+    // Index following the last entry of the logs (with the entries removed by a snapshot)
+    size_t size() const;
+    // True if there is no entry in the logs and no snapshot
+    bool empty() const;
+
+    // Index of the first entry that was not removed by a snapshot
+    size_t first_index() const;
+    // Term of the entry at the given index, which can also be the last entry of the snapshot (-1 if there is no such entry)
+    int term_at(int index) const;
+    // Term of the last entry of the logs (-1 if the logs are empty)
+    int last_term() const;
+
+    // Function used to remove all the entries until the given index (included), when they are saved in a snapshot
+    void compact(size_t last_included_index);
+    // Function used to remove all the entries from the given index (included), when they conflict with the leader logs
+    // The entries before the given index are not moved, so the cost only depends on the number of removed entries
+    void truncate(size_t index);
+    // Function used to replace all the entries by a snapshot ending with the given entry
+    void reset(size_t last_included_index, int last_included_term);
+
+    // Index of the last entry with a term lower or equal to the given term (-1 if there is none)
+    // As the terms of the logs are increasing, this is done with a binary search
+    int last_index_until_term(int term) const;
+
+    // Encodings of the entries from the index from to the end of the logs (to be sent in an AppendEntries)
+    // The view is only valid until the logs are modified
+    std::string_view encoded_entries(size_t from) const;
+    // Encodings of the entries from the index from to the index to (excluded)
+    std::string_view encoded_entries(size_t from, size_t to) const;
+
+private:
+    // Entry of the logs : its term, and the size and the offset of its encoding in the arena
+    struct Record
+    {
+        int32_t _term;
+        uint32_t _size;
+        size_t _offset;
+    };
+
+    // Size of the fields encoded before the command of an entry (its term, its client session and the length of the command)
+    static const size_t ENTRY_HEADER_SIZE = 4 * sizeof(int32_t) + sizeof(uint32_t);
+
+    // Offset of the encoding of the entry at the given position in the records (the end of the arena after the last one)
+    size_t encoded_offset(size_t position) const;
+
+    // Index of the first entry of the logs, and term of the entry before it (the last entry of the snapshot, -1 if there is none)
+    size_t _first_index;
+    int _snapshot_term;
+    // Records of the entries of the logs (from the first index)
+    std::vector<Record> _records;
+    // Binary encodings of all the entries, one after the other
+    std::string _arena;
+};
@@ -0,0 +1,283 @@
+#include "snapshot_store.hpp"
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <iostream>
+#include <stdexcept>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "log/file_utils.hpp"
+#include "log/write_ahead_log.hpp"
+#include "rpc/codec/binary_codec.hpp"
+
+// Function used to encode the fields written before the state of a snapshot
+static std::string encode_header(int last_included_index, int last_included_term, size_t state_size)
+{
+    std::string header;
+    BinaryWriter writer = BinaryWriter(header);
+    writer.write_uint32(SnapshotStore::SNAPSHOT_MAGIC);
+    writer.write_int32(last_included_index);
+    writer.write_int32(last_included_term);
+    writer.write_uint32(state_size);
+    return header;
+}
+
+// Function used to read the fields written before the state of a snapshot (returns false if they are not valid)
+static bool decode_header(int fd, SnapshotStore::Snapshot& snapshot)
+{
+    char header[SnapshotStore::SNAPSHOT_HEADER_SIZE];
+    if (pread(fd, header, sizeof(header), 0) != (ssize_t)sizeof(header))
+    {
+        return false;
+    }
+    BinaryReader reader = BinaryReader(header, sizeof(header));
+    if (reader.read_uint32() != SnapshotStore::SNAPSHOT_MAGIC)
+    {
+        return false;
+    }
+    snapshot._last_included_index = reader.read_int32();
+    snapshot._last_included_term = reader.read_int32();
+    snapshot._state_size = reader.read_uint32();
+    return true;
+}
+
+// Size of the file of the given file descriptor
+static size_t file_size(int fd)
+{
+    struct stat file_stat;
+    return fstat(fd, &file_stat) == 0 ? file_stat.st_size : 0;
+}
+
+// ========== SnapshotStore class implementation ==========
+
+SnapshotStore::SnapshotStore(const std::string& filepath)
+    : _filepath(filepath), _part_filepath(filepath + ".part")
+{}
+
+bool SnapshotStore::copy_range(int input_fd, size_t offset, size_t size, int output_fd, uint32_t& crc)
+{
+    std::string buffer(std::min(size, COPY_CHUNK_SIZE), '\0');
+    size_t copied = 0;
+    while (copied < size)
+    {
+        const ssize_t result = pread(input_fd, buffer.data(), std::min(size - copied, buffer.size()), offset + copied);
+        if (result < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (result <= 0)
+        {
+            return false;
+        }
+        crc = WriteAheadLog::crc32(buffer.data(), result, crc);
+        if (output_fd >= 0 && !write_all(output_fd, buffer.data(), result))
+        {
+            return false;
+        }
+        copied += result;
+    }
+    return true;
+}
+
+bool SnapshotStore::load(Snapshot& snapshot) const
+{
+    const int fd = open(this->_filepath.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    // The state is read by chunks to compute the CRC32 of the file, which is then compared with the one at the end of the file
+    Snapshot loaded_snapshot;
+    bool valid = decode_header(fd, loaded_snapshot) && file_size(fd) == SNAPSHOT_HEADER_SIZE + loaded_snapshot._state_size + sizeof(uint32_t);
+    if (valid)
+    {
+        const std::string header = encode_header(loaded_snapshot._last_included_index, loaded_snapshot._last_included_term, loaded_snapshot._state_size);
+        uint32_t crc = WriteAheadLog::crc32(header.data(), header.size());
+        valid = copy_range(fd, SNAPSHOT_HEADER_SIZE, loaded_snapshot._state_size, -1, crc)
+                && pread(fd, &loaded_snapshot._crc, sizeof(uint32_t), SNAPSHOT_HEADER_SIZE + loaded_snapshot._state_size) == sizeof(uint32_t)
+                && loaded_snapshot._crc == crc;
+    }
+    close(fd);
+
+    if (valid)
+    {
+        snapshot = loaded_snapshot;
+    }
+    return valid;
+}
+
+bool SnapshotStore::store(int last_included_index, int last_included_term, const std::string& state_filepath, Snapshot& snapshot)
+{
+    const int state_fd = open(state_filepath.c_str(), O_RDONLY);
+    if (state_fd < 0)
+    {
+        std::cerr << "Unable to open file : " << state_filepath << " (" << std::strerror(errno) << ")" << std::endl;
+        return false;
+    }
+    const std::string temporary_filepath = this->_filepath + ".tmp";
+    const int fd = open(temporary_filepath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if (fd < 0)
+    {
+        std::cerr << "Unable to open file : " << temporary_filepath << " (" << std::strerror(errno) << ")" << std::endl;
+        close(state_fd);
+        return false;
+    }
+
+    // The state file is copied by chunks after the header, followed by the CRC32 of the whole snapshot
+    Snapshot new_snapshot = Snapshot{last_included_index, last_included_term, file_size(state_fd), 0};
+    const std::string header = encode_header(last_included_index, last_included_term, new_snapshot._state_size);
+    new_snapshot._crc = WriteAheadLog::crc32(header.data(), header.size());
+    const bool synced = write_all(fd, header.data(), header.size())
+                        && copy_range(state_fd, 0, new_snapshot._state_size, fd, new_snapshot._crc)
+                        && write_all(fd, (const char*)&new_snapshot._crc, sizeof(uint32_t))
+                        && fdatasync(fd) == 0;
+    close(fd);
+    close(state_fd);
+
+    if (!synced || std::rename(temporary_filepath.c_str(), this->_filepath.c_str()) != 0)
+    {
+        std::cerr << "Unable to write file : " << this->_filepath << " (" << std::strerror(errno) << ")" << std::endl;
+        return false;
+    }
+    sync_directory(std::filesystem::path(this->_filepath).parent_path().string());
+    snapshot = new_snapshot;
+    return true;
+}
+
+bool SnapshotStore::restore_state(const std::string& state_filepath) const
+{
+    const int fd = open(this->_filepath.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return false;
+    }
+    Snapshot snapshot;
+    const int state_fd = decode_header(fd, snapshot) ? open(state_filepath.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644) : -1;
+    uint32_t crc = 0;
+    const bool restored = state_fd >= 0 && copy_range(fd, SNAPSHOT_HEADER_SIZE, snapshot._state_size, state_fd, crc);
+    if (state_fd >= 0)
+    {
+        close(state_fd);
+    }
+    close(fd);
+    return restored;
+}
+
+std::string SnapshotStore::read_chunk(size_t offset, size_t size) const
+{
+    std::string chunk(size, '\0');
+    const int fd = open(this->_filepath.c_str(), O_RDONLY);
+    size_t read_size = 0;
+    while (fd >= 0 && read_size < size)
+    {
+        const ssize_t result = pread(fd, chunk.data() + read_size, size - read_size, SNAPSHOT_HEADER_SIZE + offset + read_size);
+        if (result < 0 && errno == EINTR)
+        {
+            continue;
+        }
+        if (result <= 0)
+        {
+            break;
+        }
+        read_size += result;
+    }
+    if (fd >= 0)
+    {
+        close(fd);
+    }
+    chunk.resize(read_size);
+    return chunk;
+}
+
+size_t SnapshotStore::received_size(int last_included_index, int last_included_term)
+{
+    const int fd = open(this->_part_filepath.c_str(), O_RDONLY);
+    if (fd < 0)
+    {
+        return 0;
+    }
+    Snapshot snapshot;
+    const bool same_snapshot = decode_header(fd, snapshot) && snapshot._last_included_index == last_included_index
+                               && snapshot._last_included_term == last_included_term;
+    const size_t size = file_size(fd);
+    close(fd);
+
+    if (!same_snapshot)
+    {
+        std::remove(this->_part_filepath.c_str());
+        return 0;
+    }
+    return size - SNAPSHOT_HEADER_SIZE;
+}
+
+bool SnapshotStore::write_chunk(int last_included_index, int last_included_term, size_t offset, std::string_view data)
+{
+    const int fd = open(this->_part_filepath.c_str(), O_WRONLY | O_CREAT, 0644);
+    if (fd < 0)
+    {
+        std::cerr << "Unable to open file : " << this->_part_filepath << " (" << std::strerror(errno) << ")" << std::endl;
+        return false;
+    }
+
+    // The header is written with the first chunk (the size of the state is only known once all the chunks are received)
+    const bool created = file_size(fd) < SNAPSHOT_HEADER_SIZE;
+    const std::string header = encode_header(last_included_index, last_included_term, 0);
+    const bool written = (!created || write_all(fd, header.data(), header.size()))
+                         && lseek(fd, SNAPSHOT_HEADER_SIZE + offset, SEEK_SET) >= 0
+                         && write_all(fd, data.data(), data.size())
+                         && fdatasync(fd) == 0;
+    close(fd);
+
+    if (!written)
+    {
+        std::cerr << "Unable to write file : " << this->_part_filepath << " (" << std::strerror(errno) << ")" << std::endl;
+        return false;
+    }
+    if (created)
+    {
+        sync_directory(std::filesystem::path(this->_part_filepath).parent_path().string());
+    }
+    return true;
+}
+
+bool SnapshotStore::install_received(int last_included_index, int last_included_term, uint32_t crc, Snapshot& snapshot)
+{
+    const int fd = open(this->_part_filepath.c_str(), O_RDWR);
+    if (fd < 0)
+    {
+        return false;
+    }
+
+    // The header is completed with the size of the state, so the file has the same content as the snapshot of the leader
+    Snapshot new_snapshot = Snapshot{last_included_index, last_included_term, file_size(fd) - SNAPSHOT_HEADER_SIZE, 0};
+    const std::string header = encode_header(last_included_index, last_included_term, new_snapshot._state_size);
+    new_snapshot._crc = WriteAheadLog::crc32(header.data(), header.size());
+    bool valid = pwrite(fd, header.data(), header.size(), 0) == (ssize_t)header.size()
+                 && copy_range(fd, SNAPSHOT_HEADER_SIZE, new_snapshot._state_size, -1, new_snapshot._crc)
+                 && new_snapshot._crc == crc;
+    valid = valid && lseek(fd, 0, SEEK_END) >= 0
+                  && write_all(fd, (const char*)&new_snapshot._crc, sizeof(uint32_t))
+                  && fdatasync(fd) == 0;
+    close(fd);
+
+    // A part file that does not match the snapshot of the leader is received again from the beginning
+    if (!valid || std::rename(this->_part_filepath.c_str(), this->_filepath.c_str()) != 0)
+    {
+        std::remove(this->_part_filepath.c_str());
+        return false;
+    }
+    sync_directory(std::filesystem::path(this->_filepath).parent_path().string());
+    snapshot = new_snapshot;
+    return true;
+}
+
+void SnapshotStore::clear()
+{
+    std::remove(this->_filepath.c_str());
+    std::remove(this->_part_filepath.c_str());
+}
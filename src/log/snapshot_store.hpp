@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// ========== SnapshotStore class ==========
+
+// Store of the last snapshot of a server, which replaces all the entries of its logs until the last included entry
+// The snapshot is written in a temporary file which is synced and then renamed, so the file always holds a complete snapshot
+// The state of the snapshot is always copied by chunks between the files, so it is never held in memory as a whole
+//
+// The file has the following binary format (written in the byte order of the host, as the RPCs) :
+//  - uint32 : magic number of the snapshots
+//  - int32  : index of the last entry included in the snapshot
+//  - int32  : term of the last entry included in the snapshot
+//  - uint32 : size of the state of the snapshot
+//  - bytes  : state of the state machine once all the entries of the snapshot are applied
+//  - uint32 : CRC32 of the previous fields
+//
+// A snapshot received from the leader is written chunk by chunk in a part file with the same format (without the CRC32)
+// The part file is kept after a crash, so the server can resume the transfer from the last received chunk
+class SnapshotStore
+{
+public:
+    struct Snapshot
+    {
+        int _last_included_index = -1;
+        int _last_included_term = -1;
+        // Size of the state of the snapshot, and CRC32 of the snapshot file (used to check a snapshot received by chunks)
+        size_t _state_size = 0;
+        uint32_t _crc = 0;
+    };
+
+    // Magic number written at the start of the file, and size of the fields before the state
+    static const uint32_t SNAPSHOT_MAGIC = 0x534E4150;
+    static const size_t SNAPSHOT_HEADER_SIZE = sizeof(uint32_t) + sizeof(int32_t) + sizeof(int32_t) + sizeof(uint32_t);
+    // Size of the chunks used to copy the state between the files
+    static constexpr size_t COPY_CHUNK_SIZE = 64 * 1024;
+
+    SnapshotStore(const std::string& filepath);
+
+    // Function used to read the header of the snapshot from the file (the whole file is read to check its CRC32)
+    // Returns false if there is no file or if it is not valid (the snapshot is then not changed)
+    bool load(Snapshot& snapshot) const;
+    // Function used to replace the snapshot of the file by the content of the state file (the new snapshot is durable when it returns true)
+    bool store(int last_included_index, int last_included_term, const std::string& state_filepath, Snapshot& snapshot);
+    // Function used to replace the content of the state file by the state of the snapshot
+    bool restore_state(const std::string& state_filepath) const;
+    // Function used to read a chunk of the state of the snapshot (the offset and the size must be in the state)
+    std::string read_chunk(size_t offset, size_t size) const;
+
+    // Function used to get the size of the state already received for the given snapshot
+    // The part file of another snapshot is removed, as the transfer of this snapshot must start from the beginning
+    size_t received_size(int last_included_index, int last_included_term);
+    // Function used to write a chunk of the state of the given snapshot in the part file, at the given offset of the state
+    // The offset must not be after the received size, and the chunk is durable when it returns true
+    bool write_chunk(int last_included_index, int last_included_term, size_t offset, std::string_view data);
+    // Function used to replace the snapshot of the file by the snapshot of the part file once all its chunks are received
+    // The part file is checked with the CRC32 of the snapshot of the leader, and removed if it does not match
+    bool install_received(int last_included_index, int last_included_term, uint32_t crc, Snapshot& snapshot);
+
+    // Function used to remove the files (when the server is starting without restoring its state)
+    void clear();
+
+private:
+    // Function used to copy size bytes of a file into another one, and to compute their CRC32 (the output fd may be -1 to only compute it)
+    static bool copy_range(int input_fd, size_t offset, size_t size, int output_fd, uint32_t& crc);
+
+    // Filepath of the snapshot, and of the snapshot being received
+    std::string _filepath;
+    std::string _part_filepath;
+};
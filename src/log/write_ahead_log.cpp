@@ -0,0 +1,497 @@
+#include "write_ahead_log.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <unistd.h>
+
+#include "log/file_utils.hpp"
+#include "rpc/codec/binary_codec.hpp"
+
+// Size of an entry of the sparse index file (index, term and offset)
+static const size_t INDEX_POINT_SIZE = sizeof(int32_t) + sizeof(int32_t) + sizeof(uint32_t);
+
+// ========== WriteAheadLog class implementation ==========
+
+WriteAheadLog::WriteAheadLog(const std::string& directory, int sync_interval, size_t segment_size)
+    : _directory(directory), _segment_size(segment_size), _segments(), _segment_fd(-1), _index_fd(-1),
+      _sync_interval(sync_interval), _sync_clock(Clock()), _unsynced(false), _pending(), _pending_index()
+{
+    std::error_code error;
+    std::filesystem::create_directories(this->_directory, error);
+    if (error)
+    {
+        std::cerr << "Unable to create write-ahead log directory : " << this->_directory << " (" << error.message() << ")" << std::endl;
+    }
+}
+
+WriteAheadLog::~WriteAheadLog()
+{
+    // Making sure that the last records are durable before closing the files
+    this->write_pending();
+    this->sync();
+    this->close_last_segment();
+}
+
+void WriteAheadLog::clear()
+{
+    this->close_last_segment();
+    this->_segments.clear();
+    this->_pending.clear();
+    this->_pending_index.clear();
+    this->_unsynced = false;
+
+    std::error_code error;
+    for (const auto& file : std::filesystem::directory_iterator(this->_directory, error))
+    {
+        std::filesystem::remove(file.path(), error);
+    }
+}
+
+bool WriteAheadLog::restore(ServerLog& logs)
+{
+    this->close_last_segment();
+    this->_segments.clear();
+    this->_pending.clear();
+    this->_pending_index.clear();
+
+    // Getting the first index of all the segments (the name of the segment files), in the order of the log
+    std::vector<int> first_indexes;
+    std::error_code error;
+    for (const auto& file : std::filesystem::directory_iterator(this->_directory, error))
+    {
+        if (file.path().extension() == ".log")
+        {
+            first_indexes.push_back(std::atoi(file.path().stem().c_str()));
+        }
+    }
+    std::sort(first_indexes.begin(), first_indexes.end());
+
+    bool complete = true;
+    size_t segment_number = 0;
+    for (; segment_number < first_indexes.size(); segment_number++)
+    {
+        const int first_index = first_indexes.at(segment_number);
+        const bool last_segment = segment_number + 1 == first_indexes.size();
+        const std::string segment_path = this->segment_path(first_index, ".log");
+        const std::string header = read_file_part(segment_path, 0, SEGMENT_HEADER_SIZE);
+        const size_t file_size = std::filesystem::file_size(segment_path, error);
+
+        // Checking the header of the segment, which must not start after the end of the restored logs
+        // (the first segment may start before the end of the restored snapshot, its first entries are then skipped)
+        BinaryReader header_reader = BinaryReader(header.data(), header.size());
+        if (error || header.size() < SEGMENT_HEADER_SIZE || header_reader.read_uint32() != SEGMENT_MAGIC
+            || header_reader.read_int32() != first_index || first_index > (int)logs.size())
+        {
+            std::cerr << "Invalid write-ahead log segment : " << segment_path << std::endl;
+            complete = false;
+            break;
+        }
+        Segment segment = Segment{first_index, header_reader.read_int32(), 0, SEGMENT_HEADER_SIZE, {}};
+        // The entries of a sealed segment end where the next segment starts
+        const int end_index = last_segment ? std::numeric_limits<int>::max() : first_indexes.at(segment_number + 1);
+
+        // Reading the index of the segment (only the entries pointing inside the segment, in the order of the log, are kept)
+        const std::string index_data = read_file(this->segment_path(first_index, ".idx"));
+        BinaryReader index_reader = BinaryReader(index_data.data(), index_data.size());
+        while (index_reader.remaining() >= INDEX_POINT_SIZE)
+        {
+            IndexPoint point;
+            point._index = index_reader.read_int32();
+            point._term = index_reader.read_int32();
+            point._offset = index_reader.read_uint32();
+            if (point._offset < SEGMENT_HEADER_SIZE || point._offset >= file_size || point._index < first_index || point._index >= end_index
+                || (!segment._index_points.empty() && point._index <= segment._index_points.back()._index))
+            {
+                break;
+            }
+            segment._index_points.push_back(point);
+        }
+
+        // Only the entries that are not in the restored logs (after the snapshot) are read, from the closest entry of the index before them
+        // A sealed segment with only entries of the snapshot is not read at all, its size is the one of its file
+        int index = first_index;
+        size_t offset = SEGMENT_HEADER_SIZE;
+        for (const IndexPoint& point : segment._index_points)
+        {
+            if (point._index > (int)logs.size())
+            {
+                break;
+            }
+            index = point._index;
+            offset = point._offset;
+        }
+        if (end_index <= (int)logs.size())
+        {
+            index = end_index;
+            offset = file_size;
+        }
+
+        // Reading the entries with a single read of the end of the segment
+        // The sealed segments were synced when they were full, so only the records of the last one are checked
+        const std::string data = offset < file_size ? read_file_part(segment_path, offset, file_size - offset) : std::string();
+        size_t position = 0;
+        while (position < data.size() && index < end_index)
+        {
+            try
+            {
+                BinaryReader record_reader = BinaryReader(data.data() + position, data.size() - position);
+                const uint32_t length = record_reader.read_uint32();
+                const uint32_t crc = record_reader.read_uint32();
+                if (length > record_reader.remaining())
+                {
+                    break;
+                }
+                const char* body = data.data() + position + 2 * sizeof(uint32_t);
+                if (last_segment && WriteAheadLog::crc32(body, length) != crc)
+                {
+                    break;
+                }
+
+                BinaryReader body_reader = BinaryReader(body, length);
+                const uint8_t type = body_reader.read_uint8();
+                const int record_index = body_reader.read_int32();
+                const LogEntryView entry = LogEntryView(body_reader);
+                if (type != RECORD_TYPE::ENTRY || record_index != index)
+                {
+                    break;
+                }
+                if (index >= (int)logs.size())
+                {
+                    logs.append(entry);
+                }
+
+                position += 2 * sizeof(uint32_t) + length;
+                index += 1;
+            }
+            catch (const std::out_of_range&)
+            {
+                break;
+            }
+        }
+        offset += position;
+        segment._entries_count = index - first_index;
+        segment._size = offset;
+
+        // Removing the entries of the index pointing after the restored records
+        while (!segment._index_points.empty() && segment._index_points.back()._index >= index)
+        {
+            segment._index_points.pop_back();
+        }
+
+        // The records that were only partially written are removed, with the following segments
+        const bool torn = offset < file_size;
+        if (torn)
+        {
+            std::cerr << "Write-ahead log segment " << segment_path << " is truncated at the entry " << index << std::endl;
+            complete = false;
+        }
+        if (segment._entries_count == 0)
+        {
+            break;
+        }
+        if (torn && ::truncate(segment_path.c_str(), segment._size) < 0)
+        {
+            std::cerr << "Unable to truncate write-ahead log segment : " << std::strerror(errno) << std::endl;
+        }
+        if (::truncate(this->segment_path(first_index, ".idx").c_str(), segment._index_points.size() * INDEX_POINT_SIZE) < 0)
+        {
+            std::cerr << "Unable to truncate write-ahead log index : " << std::strerror(errno) << std::endl;
+        }
+        this->_segments.push_back(std::move(segment));
+        if (torn)
+        {
+            segment_number += 1;
+            break;
+        }
+    }
+
+    // Removing the segments that could not be restored (they are after a missing or partially written entry)
+    for (; segment_number < first_indexes.size(); segment_number++)
+    {
+        std::filesystem::remove(this->segment_path(first_indexes.at(segment_number), ".log"), error);
+        std::filesystem::remove(this->segment_path(first_indexes.at(segment_number), ".idx"), error);
+    }
+
+    if (!this->_segments.empty())
+    {
+        complete = this->open_last_segment() && complete;
+    }
+    return complete;
+}
+
+void WriteAheadLog::append(int index, const LogEntryView& entry)
+{
+    const int term = entry._term;
+    // Starting a new segment if the current one is full
+    if (this->_segments.empty() || this->_segments.back()._size >= this->_segment_size)
+    {
+        this->open_segment(index, term);
+    }
+    Segment& segment = this->_segments.back();
+
+    // Adding the entry to the sparse index of the segment every INDEX_INTERVAL entries, and if it is the first entry of its term
+    if (segment._entries_count % INDEX_INTERVAL == 0 || segment._index_points.empty() || segment._index_points.back()._term != term)
+    {
+        segment._index_points.push_back(IndexPoint{index, term, (uint32_t)segment._size});
+        BinaryWriter index_writer = BinaryWriter(this->_pending_index);
+        index_writer.write_int32(index);
+        index_writer.write_int32(term);
+        index_writer.write_uint32(segment._size);
+    }
+
+    // Writing the record, the length and the CRC32 of the body are written once the body is written
+    const size_t position = this->_pending.size();
+    BinaryWriter writer = BinaryWriter(this->_pending);
+    writer.write_uint32(0);
+    writer.write_uint32(0);
+    writer.write_uint8(RECORD_TYPE::ENTRY);
+    writer.write_int32(index);
+    entry.serialize_content(writer);
+
+    const size_t body_position = position + 2 * sizeof(uint32_t);
+    const size_t body_size = this->_pending.size() - body_position;
+    writer.patch_uint32(position, body_size);
+    writer.patch_uint32(position + sizeof(uint32_t), WriteAheadLog::crc32(this->_pending.data() + body_position, body_size));
+
+    segment._size += this->_pending.size() - position;
+    segment._entries_count += 1;
+}
+
+void WriteAheadLog::truncate(int index)
+{
+    this->write_pending();
+
+    // Removing all the segments starting after the index
+    while (!this->_segments.empty() && this->_segments.back()._first_index >= index)
+    {
+        this->close_last_segment();
+        std::error_code error;
+        std::filesystem::remove(this->segment_path(this->_segments.back()._first_index, ".log"), error);
+        std::filesystem::remove(this->segment_path(this->_segments.back()._first_index, ".idx"), error);
+        this->_segments.pop_back();
+    }
+    if (this->_segments.empty())
+    {
+        return;
+    }
+    if (this->_segment_fd < 0 && !this->open_last_segment())
+    {
+        return;
+    }
+
+    Segment& segment = this->_segments.back();
+    if (index >= segment._first_index + segment._entries_count)
+    {
+        return;
+    }
+
+    // Finding the offset of the entry from the closest entry of the index before it
+    auto point = std::upper_bound(segment._index_points.begin(), segment._index_points.end(), index,
+                                  [](int value, const IndexPoint& point) { return value < point._index; });
+    int current_index = segment._first_index;
+    size_t offset = SEGMENT_HEADER_SIZE;
+    if (point != segment._index_points.begin())
+    {
+        current_index = std::prev(point)->_index;
+        offset = std::prev(point)->_offset;
+    }
+    while (current_index < index)
+    {
+        uint32_t length;
+        if (pread(this->_segment_fd, &length, sizeof(length), offset) != sizeof(length))
+        {
+            std::cerr << "Unable to read write-ahead log segment : " << this->segment_path(segment._first_index, ".log") << std::endl;
+            return;
+        }
+        offset += 2 * sizeof(uint32_t) + length;
+        current_index += 1;
+    }
+
+    // Removing the entries from the segment and from its index
+    segment._index_points.erase(point, segment._index_points.end());
+    if (!segment._index_points.empty() && segment._index_points.back()._index >= index)
+    {
+        segment._index_points.pop_back();
+    }
+    if (ftruncate(this->_segment_fd, offset) < 0 || ftruncate(this->_index_fd, segment._index_points.size() * INDEX_POINT_SIZE) < 0)
+    {
+        std::cerr << "Unable to truncate write-ahead log segment : " << std::strerror(errno) << std::endl;
+    }
+    segment._size = offset;
+    segment._entries_count = index - segment._first_index;
+    this->_unsynced = true;
+}
+
+void WriteAheadLog::compact(int last_included_index)
+{
+    // Removing the segments with only entries of the snapshot (the last segment is kept to append the next entries)
+    while (this->_segments.size() > 1 && this->_segments.at(1)._first_index <= last_included_index + 1)
+    {
+        std::error_code error;
+        std::filesystem::remove(this->segment_path(this->_segments.front()._first_index, ".log"), error);
+        std::filesystem::remove(this->segment_path(this->_segments.front()._first_index, ".idx"), error);
+        this->_segments.erase(this->_segments.begin());
+    }
+}
+
+bool WriteAheadLog::flush()
+{
+    if (!this->write_pending())
+    {
+        return false;
+    }
+
+    // Syncing the file on every flush, or only once the sync interval is over
+    if (this->_unsynced && (this->_sync_interval == 0 || this->_sync_clock.check() >= this->_sync_interval))
+    {
+        return this->sync();
+    }
+    return true;
+}
+
+bool WriteAheadLog::has_pending() const
+{
+    return !this->_pending.empty();
+}
+
+uint32_t WriteAheadLog::crc32(const char* data, size_t size, uint32_t crc)
+{
+    // Table of the CRC32 (polynomial 0xEDB88320) of all the bytes, computed on the first call
+    static const std::array<uint32_t, 256> table = []() {
+        std::array<uint32_t, 256> values;
+        for (uint32_t i = 0; i < 256; i++)
+        {
+            uint32_t value = i;
+            for (int bit = 0; bit < 8; bit++)
+            {
+                value = (value & 1) ? (value >> 1) ^ 0xEDB88320 : value >> 1;
+            }
+            values[i] = value;
+        }
+        return values;
+    }();
+
+    crc = crc ^ 0xFFFFFFFF;
+    for (size_t i = 0; i < size; i++)
+    {
+        crc = table[(crc ^ (uint8_t)data[i]) & 0xFF] ^ (crc >> 8);
+    }
+    return crc ^ 0xFFFFFFFF;
+}
+
+std::string WriteAheadLog::segment_path(int first_index, const std::string& extension) const
+{
+    // The first index is padded with zeros so that the segments are listed in the order of the log
+    std::string name = std::to_string(first_index);
+    name.insert(0, name.size() < 10 ? 10 - name.size() : 0, '0');
+    return this->_directory + "/" + name + extension;
+}
+
+bool WriteAheadLog::open_segment(int first_index, int first_term)
+{
+    // The full segment is synced, so that it does not need to be checked when the log is restored
+    if (this->_segment_fd >= 0)
+    {
+        this->write_pending();
+        this->sync();
+        this->close_last_segment();
+    }
+
+    this->_segments.push_back(Segment{first_index, first_term, 0, SEGMENT_HEADER_SIZE, {}});
+    const std::string segment_path = this->segment_path(first_index, ".log");
+    const std::string index_path = this->segment_path(first_index, ".idx");
+    this->_segment_fd = open(segment_path.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_APPEND, 0644);
+    this->_index_fd = open(index_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC | O_APPEND, 0644);
+    if (this->_segment_fd < 0 || this->_index_fd < 0)
+    {
+        std::cerr << "Unable to create write-ahead log segment : " << segment_path << " (" << std::strerror(errno) << ")" << std::endl;
+        return false;
+    }
+
+    // Syncing the directory so that the new segment file is not lost
+    sync_directory(this->_directory);
+
+    // The header is written with the first records of the segment
+    BinaryWriter writer = BinaryWriter(this->_pending);
+    writer.write_uint32(SEGMENT_MAGIC);
+    writer.write_int32(first_index);
+    writer.write_int32(first_term);
+    return true;
+}
+
+bool WriteAheadLog::open_last_segment()
+{
+    const Segment& segment = this->_segments.back();
+    const std::string segment_path = this->segment_path(segment._first_index, ".log");
+    const std::string index_path = this->segment_path(segment._first_index, ".idx");
+    this->_segment_fd = open(segment_path.c_str(), O_RDWR | O_APPEND);
+    this->_index_fd = open(index_path.c_str(), O_WRONLY | O_CREAT | O_APPEND, 0644);
+    if (this->_segment_fd < 0 || this->_index_fd < 0)
+    {
+        std::cerr << "Unable to open write-ahead log segment : " << segment_path << " (" << std::strerror(errno) << ")" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void WriteAheadLog::close_last_segment()
+{
+    if (this->_segment_fd >= 0)
+    {
+        close(this->_segment_fd);
+        this->_segment_fd = -1;
+    }
+    if (this->_index_fd >= 0)
+    {
+        close(this->_index_fd);
+        this->_index_fd = -1;
+    }
+}
+
+bool WriteAheadLog::write_pending()
+{
+    if (this->_pending.empty() && this->_pending_index.empty())
+    {
+        return true;
+    }
+    if (this->_segment_fd < 0 || this->_index_fd < 0)
+    {
+        this->_pending.clear();
+        this->_pending_index.clear();
+        return false;
+    }
+
+    // The records are written before their index entries, so that the index never points to a record that is not written
+    if (!write_all(this->_segment_fd, this->_pending.data(), this->_pending.size()) ||
+        !write_all(this->_index_fd, this->_pending_index.data(), this->_pending_index.size()))
+    {
+        std::cerr << "Unable to write in the write-ahead log : " << this->_directory << " (" << std::strerror(errno) << ")" << std::endl;
+        return false;
+    }
+    this->_unsynced = this->_unsynced || !this->_pending.empty();
+    this->_pending.clear();
+    this->_pending_index.clear();
+    return true;
+}
+
+bool WriteAheadLog::sync()
+{
+    if (this->_unsynced && this->_segment_fd >= 0)
+    {
+        if (fdatasync(this->_segment_fd) < 0)
+        {
+            std::cerr << "Unable to sync the write-ahead log : " << this->_directory << " (" << std::strerror(errno) << ")" << std::endl;
+            return false;
+        }
+        this->_unsynced = false;
+        this->_sync_clock.reset();
+    }
+    return true;
+}
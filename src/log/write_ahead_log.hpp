@@ -0,0 +1,133 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "clock/clock.hpp"
+#include "log/server_log.hpp"
+
+// ========== WriteAheadLog class ==========
+
+// Write-ahead log of a server, where the entries are written before being acknowledged
+// The records are kept in memory when they are added and written all at once (with a single write and sync) by flush
+// This way, all the entries received during an update of the server are made durable together (group commit)
+//
+// The log is split in segment files of a fixed maximum size, named by the index of their first entry
+// Each segment file starts with a header :
+//  - uint32 : magic number of the segments
+//  - int32  : index of the first entry of the segment
+//  - int32  : term of the first entry of the segment
+// Followed by the records of the entries, with the following binary format (written in the byte order of the host, as the RPCs) :
+//  - uint32 : length of the body of the record
+//  - uint32 : CRC32 of the body of the record (used to detect a record that was only partially written)
+//  - body   : uint8 type of the record, int32 index and the entry (int32 term, int32 client id, int32 sequence, int32 answered sequence and its command)
+//
+// Each segment also has a sparse index file, with the offset of one entry every INDEX_INTERVAL entries and of the first entry of each term
+// The index is used to find an entry in a segment without reading all the segment (to truncate the log, and to restore only the entries after the snapshot)
+class WriteAheadLog
+{
+public:
+    enum RECORD_TYPE
+    {
+        // Entry appended to the logs
+        ENTRY = 0
+    };
+
+    // Magic number written at the start of the segments, and size of their header
+    static const uint32_t SEGMENT_MAGIC = 0x57414C53;
+    static const size_t SEGMENT_HEADER_SIZE = sizeof(uint32_t) + sizeof(int32_t) + sizeof(int32_t);
+    // Number of entries between two entries of the sparse index
+    static const int INDEX_INTERVAL = 32;
+
+    // The log is written in the given directory, in segments of at most segment_size bytes (a segment has at least one entry)
+    // The sync interval is the time (in milliseconds) between two syncs of the file, if it is 0 the file is synced on every flush
+    WriteAheadLog(const std::string& directory, int sync_interval, size_t segment_size);
+    ~WriteAheadLog();
+
+    // The log owns its file descriptors, so it can not be copied
+    WriteAheadLog(const WriteAheadLog&) = delete;
+    WriteAheadLog& operator=(const WriteAheadLog&) = delete;
+
+    // Function used to remove all the segments of the log (when the server is starting without restoring its logs)
+    void clear();
+    // Function used to rebuild the logs from the segments (when the server is restarting)
+    // The segments are described from their header, their index and the first index of the next segment, without reading their records
+    // The logs may already hold a snapshot, only the records after it are then read, from the closest entry of the index before them
+    // Only the records of the last segment are checked, as the other segments are synced when they are full
+    // A record that was only partially written is removed from the segment with all the following ones
+    // Returns false if some records could not be restored
+    bool restore(ServerLog& logs);
+
+    // Function used to add an entry to the log (the record is only written by the next flush)
+    void append(int index, const LogEntryView& entry);
+    // Function used to remove all the entries from the given index
+    // The pending records are written first, then the segments are truncated directly
+    void truncate(int index);
+    // Function used to remove the segments with only entries until the given index (included), when they are saved in a snapshot
+    void compact(int last_included_index);
+
+    // Function used to write all the records added since the last flush, and to sync the file depending on the sync interval
+    // Returns false if the records could not be written
+    bool flush();
+    // True if there are records that are not written yet
+    bool has_pending() const;
+
+    // CRC32 of the given data (used to check the records)
+    // The CRC32 of data read in several parts is computed by giving the CRC32 of the previous parts
+    static uint32_t crc32(const char* data, size_t size, uint32_t crc = 0);
+
+private:
+    // Entry of the sparse index of a segment (the offset is the position of the record in the segment file)
+    struct IndexPoint
+    {
+        int32_t _index;
+        int32_t _term;
+        uint32_t _offset;
+    };
+
+    // Segment of the log (only the last one is opened, to append the new entries)
+    struct Segment
+    {
+        int _first_index;
+        int _first_term;
+        int _entries_count;
+        // Size of the segment, with the records that are not written yet
+        size_t _size;
+        std::vector<IndexPoint> _index_points;
+    };
+
+    // Filepath of the segment file or of the index file of the segment starting at the given index
+    std::string segment_path(int first_index, const std::string& extension) const;
+    // Function used to create a new segment starting with the given entry (the current segment is synced and closed)
+    bool open_segment(int first_index, int first_term);
+    // Function used to open the files of the last segment to append entries to it
+    bool open_last_segment();
+    // Function used to close the files of the last segment
+    void close_last_segment();
+    // Function used to write the pending records and index entries (without syncing them)
+    bool write_pending();
+    // Function used to sync the last segment file
+    bool sync();
+
+    // Directory of the segments
+    std::string _directory;
+    // Maximum size of a segment
+    size_t _segment_size;
+    // Segments of the log, ordered by their first index
+    std::vector<Segment> _segments;
+    // File descriptors of the last segment and of its index (-1 if they are not opened)
+    int _segment_fd;
+    int _index_fd;
+
+    // Time between two syncs of the file (0 to sync on every flush)
+    int _sync_interval;
+    // Clock started at the last sync of the file
+    Clock _sync_clock;
+    // True if some records were written and not synced yet
+    bool _unsynced;
+    // Records and index entries added since the last flush
+    std::string _pending;
+    std::string _pending_index;
+};
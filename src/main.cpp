@@ -49,6 +49,197 @@ int main(int argc, char **argv)
         }
     }
     
+    // Parsing the options of the servers
+    ServerConfig server_config;
+    if (args.find("pipeline_window") != args.end())
+    {
+        server_config.pipeline_window = args["pipeline_window"];
+
+        // Checking for errors
+        if (server_config.pipeline_window < 0)
+        {
+            std::cerr << "Invalid pipeline window (the window must be positive or 0 to disable it) : " << server_config.pipeline_window << std::endl;
+            return -1;
+        }
+    }
+
+    if (args.find("eager_replication") != args.end())
+    {
+        server_config.eager_replication = true;
+    }
+    if (args.find("batch_window") != args.end())
+    {
+        server_config.batch_window = args["batch_window"];
+
+        // Checking for errors
+        if (server_config.batch_window < 0)
+        {
+            std::cerr << "Invalid batch window (the window must be positive) : " << server_config.batch_window << std::endl;
+            return -1;
+        }
+    }
+
+    if (args.find("wal_sync_interval") != args.end())
+    {
+        server_config.wal_sync_interval = args["wal_sync_interval"];
+
+        // Checking for errors
+        if (server_config.wal_sync_interval < 0)
+        {
+            std::cerr << "Invalid write-ahead log sync interval (the interval must be positive or 0 to sync on every write) : " << server_config.wal_sync_interval << std::endl;
+            return -1;
+        }
+    }
+
+    if (args.find("segment_size") != args.end())
+    {
+        server_config.segment_size = args["segment_size"];
+
+        // Checking for errors
+        if (server_config.segment_size <= 0)
+        {
+            std::cerr << "Invalid write-ahead log segment size (the size must be strictly positive) : " << server_config.segment_size << std::endl;
+            return -1;
+        }
+    }
+    if (args.find("snapshot_threshold") != args.end())
+    {
+        server_config.snapshot_threshold = args["snapshot_threshold"];
+
+        // Checking for errors
+        if (server_config.snapshot_threshold < 0)
+        {
+            std::cerr << "Invalid snapshot threshold (the threshold must be positive or 0 to disable the snapshots) : " << server_config.snapshot_threshold << std::endl;
+            return -1;
+        }
+    }
+    if (args.find("snapshot_chunk_size") != args.end())
+    {
+        server_config.snapshot_chunk_size = args["snapshot_chunk_size"];
+
+        // Checking for errors
+        if (server_config.snapshot_chunk_size <= 0)
+        {
+            std::cerr << "Invalid snapshot chunk size (the size must be strictly positive) : " << server_config.snapshot_chunk_size << std::endl;
+            return -1;
+        }
+    }
+    if (args.find("lease_read") != args.end())
+    {
+        server_config.lease_read = true;
+    }
+    if (args.find("lease_drift") != args.end())
+    {
+        server_config.lease_drift = args["lease_drift"];
+
+        // Checking for errors
+        if (server_config.lease_drift < 0)
+        {
+            std::cerr << "Invalid lease drift (the drift must be positive) : " << server_config.lease_drift << std::endl;
+            return -1;
+        }
+    }
+    if (args.find("follower_reads") != args.end())
+    {
+        server_config.follower_reads = true;
+    }
+    if (args.find("forward_proposals") != args.end())
+    {
+        server_config.forward_proposals = true;
+    }
+    if (args.find("busy_poll") != args.end())
+    {
+        server_config.busy_poll = true;
+    }
+    if (args.find("poll_interval") != args.end())
+    {
+        server_config.poll_interval = args["poll_interval"];
+
+        // Checking for errors
+        if (server_config.poll_interval <= 0)
+        {
+            std::cerr << "Invalid poll interval (the time must be strictly positive) : " << server_config.poll_interval << std::endl;
+            return -1;
+        }
+    }
+    if (args.find("receive_budget") != args.end())
+    {
+        server_config.receive_budget = args["receive_budget"];
+
+        // Checking for errors
+        if (server_config.receive_budget <= 0)
+        {
+            std::cerr << "Invalid receive budget (the number of messages must be strictly positive) : " << server_config.receive_budget << std::endl;
+            return -1;
+        }
+    }
+    if (args.find("max_staleness") != args.end())
+    {
+        server_config.max_staleness = args["max_staleness"];
+
+        // Checking for errors
+        if (server_config.max_staleness < 0)
+        {
+            std::cerr << "Invalid maximum staleness (the staleness must be positive) : " << server_config.max_staleness << std::endl;
+            return -1;
+        }
+    }
+    if (args.find("kv_store") != args.end())
+    {
+        server_config.kv_store = true;
+    }
+    if (args.find("restore") != args.end())
+    {
+        server_config.restore = true;
+    }
+
+    // Parsing the options of the clients
+    ClientConfig client_config;
+    client_config.follower_reads = server_config.follower_reads;
+    client_config.forward_proposals = server_config.forward_proposals;
+    client_config.busy_poll = server_config.busy_poll;
+    client_config.poll_interval = server_config.poll_interval;
+    client_config.receive_budget = server_config.receive_budget;
+    if (args.find("client_window") != args.end())
+    {
+        client_config.client_window = args["client_window"];
+
+        // Checking for errors
+        if (client_config.client_window <= 0)
+        {
+            std::cerr << "Invalid client window (the window must be strictly positive) : " << client_config.client_window << std::endl;
+            return -1;
+        }
+    }
+    if (args.find("client_batch_entries") != args.end())
+    {
+        client_config.batch_entries = args["client_batch_entries"];
+
+        // Checking for errors
+        if (client_config.batch_entries <= 0)
+        {
+            std::cerr << "Invalid client batch entries (the number of entries must be strictly positive) : " << client_config.batch_entries << std::endl;
+            return -1;
+        }
+    }
+    if (args.find("client_batch_bytes") != args.end())
+    {
+        client_config.batch_bytes = args["client_batch_bytes"];
+
+        // Checking for errors
+        if (client_config.batch_bytes <= 0)
+        {
+            std::cerr << "Invalid client batch bytes (the number of bytes must be strictly positive) : " << client_config.batch_bytes << std::endl;
+            return -1;
+        }
+    }
+
+    // Using the JSON wire format if asked (only used to debug the messages as it is slower than the binary one)
+    if (args.find("json") != args.end())
+    {
+        RPC::set_wire_format(RPC::WIRE_FORMAT::JSON);
+    }
+    
     // Start the MPI instances
     int rank;
     int size;
@@ -77,7 +268,7 @@ int main(int argc, char **argv)
         // Try to create the directory for the clients commands (should be here but if not, create it) 
         // If the directory is already here, then it won't do anything
         std::filesystem::create_directories("client_commands");
-        Client client = Client(rank, serv_num, clients_num);
+        Client client = Client(rank, serv_num, clients_num, client_config);
         client.run_client();
     }
     // For any other instances, run a server
@@ -86,7 +277,7 @@ int main(int argc, char **argv)
         // Try to create the directory for the server logs 
         // If the directory is already here, then it won't do anything
         std::filesystem::create_directories("server_logs");
-        Server server = Server(rank, serv_num, clients_num);
+        Server server = Server(rank, serv_num, clients_num, server_config);
         server.run_server();
     }
 
@@ -15,6 +15,13 @@ Message::Message(const std::string& serialized)
     : Message(nlohmann::json::parse(serialized))
 {}
 
+// The fields are read in the member initializer list as it is the only way to be sure of the reading order
+Message::Message(BinaryReader& reader)
+    : RPC(-1, RPC::RPC_TYPE::MESSAGE), 
+      _type((MESSAGE_TYPE)reader.read_uint8()), 
+      _content(reader.read_string())
+{}
+
 nlohmann::json Message::serialize_content() const
 {
     nlohmann::json json_object;
@@ -23,6 +30,12 @@ nlohmann::json Message::serialize_content() const
     return json_object;
 }
 
+void Message::serialize_content(BinaryWriter& writer) const
+{
+    writer.write_uint8(this->_type);
+    writer.write_string(this->_content);
+}
+
 // ========== MessageResponse class implementation ==========
 
 // Setting up the term to -1 as this is the response to the message and the term of the server won't be of any use for the client
@@ -38,9 +51,18 @@ MessageResponse::MessageResponse(const std::string& serialized)
     : MessageResponse(nlohmann::json::parse(serialized))
 {}
 
+MessageResponse::MessageResponse(BinaryReader& reader) 
+    : MessageResponse(reader.read_bool())
+{}
+
 nlohmann::json MessageResponse::serialize_content() const
 {
     nlohmann::json json_object;
     json_object["success"] = this->_success;
     return json_object;
+}
+
+void MessageResponse::serialize_content(BinaryWriter& writer) const
+{
+    writer.write_bool(this->_success);
 }
\ No newline at end of file
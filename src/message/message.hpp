@@ -22,8 +22,10 @@ public:
     Message(MESSAGE_TYPE message_type, std::string message_content);
     Message(const nlohmann::json& serialized_json);
     Message(const std::string& serialized);
+    Message(BinaryReader& reader);
 
     nlohmann::json serialize_content() const override;
+    void serialize_content(BinaryWriter& writer) const override;
 
     // Type of the message
     const MESSAGE_TYPE _type;
@@ -37,8 +39,10 @@ public:
     MessageResponse(bool success);
     MessageResponse(const nlohmann::json& serialized_json);
     MessageResponse(const std::string& serialized);
+    MessageResponse(BinaryReader& reader);
 
     nlohmann::json serialize_content() const override;
+    void serialize_content(BinaryWriter& writer) const override;
 
     // Response to the message depending if the actions that the message asked to do is done
     bool _success;
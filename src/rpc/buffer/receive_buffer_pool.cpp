@@ -0,0 +1,35 @@
+#include "receive_buffer_pool.hpp"
+
+// ========== ReceiveBufferPool class implementation ==========
+
+std::vector<std::unique_ptr<std::vector<char>>> ReceiveBufferPool::_free_buffers;
+
+ReceiveBufferPool::Buffer ReceiveBufferPool::acquire(size_t size)
+{
+    std::unique_ptr<std::vector<char>> buffer;
+    if (ReceiveBufferPool::_free_buffers.empty())
+    {
+        buffer = std::make_unique<std::vector<char>>();
+    }
+    else
+    {
+        buffer = std::move(ReceiveBufferPool::_free_buffers.back());
+        ReceiveBufferPool::_free_buffers.pop_back();
+    }
+
+    // The capacity of the buffer is kept between the uses so this will only allocate if the message is bigger than the previous ones
+    buffer->resize(size);
+    return Buffer(buffer.release(), ReceiveBufferPool::release);
+}
+
+void ReceiveBufferPool::release(std::vector<char>* buffer)
+{
+    if (ReceiveBufferPool::_free_buffers.size() < ReceiveBufferPool::MAX_FREE_BUFFERS)
+    {
+        ReceiveBufferPool::_free_buffers.emplace_back(buffer);
+    }
+    else
+    {
+        delete buffer;
+    }
+}
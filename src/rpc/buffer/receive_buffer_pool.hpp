@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+// ========== ReceiveBufferPool class ==========
+
+// Pool of the buffers used to receive the MPI messages
+// The received queries are decoded directly from those buffers (the log entries commands are views in them),
+// so a buffer is kept alive as long as a query is using it and is given back to the pool when it is not used anymore
+class ReceiveBufferPool
+{
+public:
+    using Buffer = std::shared_ptr<std::vector<char>>;
+
+    // Function used to get a buffer of the given size (reusing a free one when there is one)
+    static Buffer acquire(size_t size);
+
+private:
+    // Function called when a buffer is not used anymore, to put it back in the free buffers
+    static void release(std::vector<char>* buffer);
+
+    // Maximum number of free buffers kept by the pool (the other ones are deleted)
+    static const size_t MAX_FREE_BUFFERS = 64;
+    // Buffers that are not used and ready to be reused
+    static std::vector<std::unique_ptr<std::vector<char>>> _free_buffers;
+};
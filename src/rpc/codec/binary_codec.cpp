@@ -0,0 +1,111 @@
+#include "binary_codec.hpp"
+
+#include <cstring>
+#include <stdexcept>
+
+// ========== BinaryWriter class implementation ==========
+
+BinaryWriter::BinaryWriter(std::string& buffer)
+    : _buffer(buffer)
+{}
+
+void BinaryWriter::write_uint8(uint8_t value)
+{
+    this->_buffer.push_back((char)value);
+}
+
+void BinaryWriter::write_int32(int32_t value)
+{
+    this->write_raw(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void BinaryWriter::write_uint32(uint32_t value)
+{
+    this->write_raw(reinterpret_cast<const char*>(&value), sizeof(value));
+}
+
+void BinaryWriter::write_bool(bool value)
+{
+    this->write_uint8(value ? 1 : 0);
+}
+
+void BinaryWriter::write_string(std::string_view value)
+{
+    this->write_uint32(value.size());
+    this->write_raw(value.data(), value.size());
+}
+
+void BinaryWriter::write_raw(const char* data, size_t size)
+{
+    this->_buffer.append(data, size);
+}
+
+void BinaryWriter::patch_uint32(size_t position, uint32_t value)
+{
+    std::memcpy(&this->_buffer[position], &value, sizeof(value));
+}
+
+size_t BinaryWriter::position() const
+{
+    return this->_buffer.size();
+}
+
+// ========== BinaryReader class implementation ==========
+
+BinaryReader::BinaryReader(const char* data, size_t size)
+    : _data(data), _size(size), _position(0)
+{}
+
+const char* BinaryReader::consume(size_t size)
+{
+    if (size > this->remaining())
+    {
+        throw std::out_of_range("Binary message is too short to be decoded");
+    }
+    const char* current = this->_data + this->_position;
+    this->_position += size;
+    return current;
+}
+
+uint8_t BinaryReader::read_uint8()
+{
+    return (uint8_t)*this->consume(sizeof(uint8_t));
+}
+
+int32_t BinaryReader::read_int32()
+{
+    int32_t value;
+    std::memcpy(&value, this->consume(sizeof(value)), sizeof(value));
+    return value;
+}
+
+uint32_t BinaryReader::read_uint32()
+{
+    uint32_t value;
+    std::memcpy(&value, this->consume(sizeof(value)), sizeof(value));
+    return value;
+}
+
+bool BinaryReader::read_bool()
+{
+    return this->read_uint8() != 0;
+}
+
+std::string BinaryReader::read_string()
+{
+    uint32_t size = this->read_uint32();
+    const char* data = this->consume(size);
+    return std::string(data, size);
+}
+
+std::string_view BinaryReader::read_string_view()
+{
+    uint32_t size = this->read_uint32();
+    const char* data = this->consume(size);
+    return std::string_view(data, size);
+}
+
+size_t BinaryReader::remaining() const
+{
+    return this->_size - this->_position;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+
+// ========== Binary codec ==========
+
+// The binary wire format is made of a fixed header followed by the packed fields of the RPC :
+//  - uint8  : magic byte (used to tell a binary message from a JSON one, which always starts with '{')
+//  - uint8  : type of the RPC
+//  - int32  : term of the RPC
+//  - uint32 : length of the payload following the header
+// All the values are written in the byte order of the host, as all the processes are running on the same architecture
+namespace BinaryCodec
+{
+    const uint8_t MAGIC = 0xA7;
+    const size_t HEADER_SIZE = sizeof(uint8_t) + sizeof(uint8_t) + sizeof(int32_t) + sizeof(uint32_t);
+}
+
+class BinaryWriter
+{
+public:
+    // The writer appends all the fields at the end of the given buffer
+    BinaryWriter(std::string& buffer);
+
+    void write_uint8(uint8_t value);
+    void write_int32(int32_t value);
+    void write_uint32(uint32_t value);
+    void write_bool(bool value);
+    // Strings are written as their uint32 length followed by their bytes
+    void write_string(std::string_view value);
+    // Raw bytes are written as they are (without any length)
+    void write_raw(const char* data, size_t size);
+
+    // Function used to overwrite an uint32 that was already written (used to patch the payload length)
+    void patch_uint32(size_t position, uint32_t value);
+    // Current size of the buffer
+    size_t position() const;
+
+private:
+    // Buffer in which the fields are written
+    std::string& _buffer;
+};
+
+class BinaryReader
+{
+public:
+    // The reader does not own the data, it must stay alive while reading
+    BinaryReader(const char* data, size_t size);
+
+    // All the read functions throw an std::out_of_range if there is not enough bytes left
+    uint8_t read_uint8();
+    int32_t read_int32();
+    uint32_t read_uint32();
+    bool read_bool();
+    std::string read_string();
+    // Same as read_string but without copying the bytes (the view is only valid while the read data is alive)
+    std::string_view read_string_view();
+
+    // Number of bytes that are not read yet
+    size_t remaining() const;
+
+private:
+    // Function used to check that the size bytes can be read and to move the cursor
+    const char* consume(size_t size);
+
+    // Data to read and size of the data
+    const char* _data;
+    size_t _size;
+    // Position of the next byte to read
+    size_t _position;
+};
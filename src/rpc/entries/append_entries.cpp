@@ -2,13 +2,26 @@
 
 // ========== AppendEntries class implementation ==========
 
-AppendEntries::AppendEntries(int term, size_t leader_rank, int prev_log_index, int prev_log_term, std::vector<LogEntry> entries, int leader_commit)
+AppendEntries::AppendEntries(int term, size_t leader_rank, int prev_log_index, int prev_log_term, std::vector<LogEntryView> entries, int leader_commit)
     : RPC(term, RPC::RPC_TYPE::APPEND_ENTRIES), 
       _leader_rank(leader_rank),
       _prev_log_index(prev_log_index), 
       _prev_log_term(prev_log_term), 
       _entries(entries), 
-      _leader_commit(leader_commit)
+      _leader_commit(leader_commit),
+      _encoded_entries(),
+      _encoded_entries_count(0)
+{}
+
+AppendEntries::AppendEntries(int term, size_t leader_rank, int prev_log_index, int prev_log_term, std::string_view encoded_entries, size_t entries_count, int leader_commit)
+    : RPC(term, RPC::RPC_TYPE::APPEND_ENTRIES), 
+      _leader_rank(leader_rank),
+      _prev_log_index(prev_log_index), 
+      _prev_log_term(prev_log_term), 
+      _entries(), 
+      _leader_commit(leader_commit),
+      _encoded_entries(encoded_entries),
+      _encoded_entries_count(entries_count)
 {}
 
 AppendEntries::AppendEntries(int term, const nlohmann::json& serialized_json)
@@ -16,15 +29,28 @@ AppendEntries::AppendEntries(int term, const nlohmann::json& serialized_json)
       _leader_rank(serialized_json["leader_rank"]),
       _prev_log_index(serialized_json["prev_log_index"]), 
       _prev_log_term(serialized_json["prev_log_term"]), 
-      _leader_commit(serialized_json["leader_commit"])
+      _leader_commit(serialized_json["leader_commit"]),
+      _encoded_entries(),
+      _encoded_entries_count(0)
 {
     for (const auto& entry : serialized_json["entries"])
-        this->_entries.push_back(entry);
+        this->_entries.emplace_back(entry);
 }
 
-AppendEntries::AppendEntries(int term, const std::string& serialized) 
-    : AppendEntries(term, nlohmann::json::parse(serialized))
-{}
+AppendEntries::AppendEntries(int term, BinaryReader& reader)
+    : RPC(term, RPC::RPC_TYPE::APPEND_ENTRIES), 
+      _leader_rank(reader.read_uint32()),
+      _prev_log_index(reader.read_int32()), 
+      _prev_log_term(reader.read_int32()), 
+      _leader_commit(reader.read_int32()),
+      _encoded_entries(),
+      _encoded_entries_count(0)
+{
+    const uint32_t entries_count = reader.read_uint32();
+    this->_entries.reserve(entries_count);
+    for (uint32_t i = 0; i < entries_count; i++)
+        this->_entries.emplace_back(reader);
+}
 
 nlohmann::json AppendEntries::serialize_content() const
 {
@@ -33,31 +59,78 @@ nlohmann::json AppendEntries::serialize_content() const
     json_object["prev_log_index"] = this->_prev_log_index;
     json_object["prev_log_term"] = this->_prev_log_term;
     json_object["entries"] = nlohmann::json::array();
-    for (LogEntry entry : this->_entries)
+    for (const LogEntryView& entry : this->_entries)
     {
         json_object["entries"].push_back(entry.serialize_content());
     }
+    // Decoding the pre-encoded entries (only done with the JSON format, used to debug)
+    BinaryReader reader = BinaryReader(this->_encoded_entries.data(), this->_encoded_entries.size());
+    for (size_t i = 0; i < this->_encoded_entries_count; i++)
+    {
+        json_object["entries"].push_back(LogEntryView(reader).serialize_content());
+    }
     json_object["leader_commit"] = this->_leader_commit;
     return json_object;
 }
 
+void AppendEntries::serialize_content(BinaryWriter& writer) const
+{
+    writer.write_uint32(this->_leader_rank);
+    writer.write_int32(this->_prev_log_index);
+    writer.write_int32(this->_prev_log_term);
+    writer.write_int32(this->_leader_commit);
+    writer.write_uint32(this->_entries.size() + this->_encoded_entries_count);
+    for (const LogEntryView& entry : this->_entries)
+    {
+        entry.serialize_content(writer);
+    }
+    // The pre-encoded entries are already in the binary format of the entries
+    writer.write_raw(this->_encoded_entries.data(), this->_encoded_entries.size());
+}
+
 // ========== AppendEntriesResponse class implementation ==========
 
-AppendEntriesResponse::AppendEntriesResponse(int term, bool success) 
-    : RPC(term, RPC::RPC_TYPE::APPEND_ENTRIES_RESPONSE), _success(success)
+AppendEntriesResponse::AppendEntriesResponse(int term, bool success, int match_index, int conflict_term, int conflict_index) 
+    : RPC(term, RPC::RPC_TYPE::APPEND_ENTRIES_RESPONSE), 
+      _success(success), 
+      _match_index(match_index),
+      _conflict_term(conflict_term),
+      _conflict_index(conflict_index)
 {}
 
 AppendEntriesResponse::AppendEntriesResponse(int term, const nlohmann::json& serialized_json)
-    : AppendEntriesResponse(term, serialized_json["success"].get<bool>())
+    : AppendEntriesResponse(term, serialized_json["success"].get<bool>(), 
+                                  serialized_json["match_index"].get<int>(),
+                                  serialized_json["conflict_term"].get<int>(),
+                                  serialized_json["conflict_index"].get<int>())
 {}
 
 AppendEntriesResponse::AppendEntriesResponse(int term, const std::string& serialized)
     : AppendEntriesResponse(term, nlohmann::json::parse(serialized))
 {}
 
+AppendEntriesResponse::AppendEntriesResponse(int term, BinaryReader& reader)
+    : RPC(term, RPC::RPC_TYPE::APPEND_ENTRIES_RESPONSE), 
+      _success(reader.read_bool()), 
+      _match_index(reader.read_int32()),
+      _conflict_term(reader.read_int32()),
+      _conflict_index(reader.read_int32())
+{}
+
 nlohmann::json AppendEntriesResponse::serialize_content() const
 {
     nlohmann::json json_object;
     json_object["success"] = this->_success;
+    json_object["match_index"] = this->_match_index;
+    json_object["conflict_term"] = this->_conflict_term;
+    json_object["conflict_index"] = this->_conflict_index;
     return json_object;
+}
+
+void AppendEntriesResponse::serialize_content(BinaryWriter& writer) const
+{
+    writer.write_bool(this->_success);
+    writer.write_int32(this->_match_index);
+    writer.write_int32(this->_conflict_term);
+    writer.write_int32(this->_conflict_index);
 }
\ No newline at end of file
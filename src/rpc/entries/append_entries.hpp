@@ -1,5 +1,6 @@
 #pragma once
 
+#include <string_view>
 #include <vector>
 
 #include "rpc/rpc.hpp"
@@ -8,12 +9,17 @@
 class AppendEntries : public RPC
 {
 public:
-    AppendEntries(int term, size_t leader_rank, int prev_log_index, int prev_log_term, std::vector<LogEntry> entries, int leader_commit);
+    AppendEntries(int term, size_t leader_rank, int prev_log_index, int prev_log_term, std::vector<LogEntryView> entries, int leader_commit);
+    // Constructor used by the leader with the entries already encoded in the binary format (the encodings are copied in the message as they are)
+    AppendEntries(int term, size_t leader_rank, int prev_log_index, int prev_log_term, std::string_view encoded_entries, size_t entries_count, int leader_commit);
+    // The entries are views in the JSON object (or the reader data) so it must be kept alive while using them
     AppendEntries(int term, const nlohmann::json& serialized_json);
-    AppendEntries(int term, const std::string& serialized);
+    AppendEntries(int term, BinaryReader& reader);
 
     // Function used to serialize the class as a json to be sent later as a string
     nlohmann::json serialize_content() const override;
+    // Function used to pack the class in the binary format
+    void serialize_content(BinaryWriter& writer) const override;
 
     // so follower can redirect clients
     const size_t _leader_rank;
@@ -22,21 +28,36 @@ public:
     // term of prev_log_index entry
     const int _prev_log_term;
     // log entries to store (empty for heartbeat may send more than one for efficiency)
-    std::vector<LogEntry> _entries;
+    std::vector<LogEntryView> _entries;
     // leader's commit_index
     const int _leader_commit;
+
+private:
+    // Binary encodings of the entries to send and their number (only used when sending pre-encoded entries, _entries is then empty)
+    std::string_view _encoded_entries;
+    size_t _encoded_entries_count;
 };
 
 class AppendEntriesResponse : public RPC
 {
 public:
-    AppendEntriesResponse(int term, bool success);
+    AppendEntriesResponse(int term, bool success, int match_index, int conflict_term = -1, int conflict_index = -1);
     AppendEntriesResponse(int term, const nlohmann::json& serialized_json);
     AppendEntriesResponse(int term, const std::string& serialized);
+    AppendEntriesResponse(int term, BinaryReader& reader);
 
     // Function used to serialize the class as a json to be sent later as a string
     nlohmann::json serialize_content() const override;
+    // Function used to pack the class in the binary format
+    void serialize_content(BinaryWriter& writer) const override;
 
     // True if the follower has a log index matching the prev_log_index of the leader and a term matchin the prev_log_term of the leader
     const bool _success;
+    // Index of the last entry of the follower matching the logs of the leader (the last entry of the request, only used on success)
+    const int _match_index;
+    // Hints given on a reject so that the leader can find the matching entry without trying all the entries one by one :
+    // If the follower has an entry at prev_log_index, the term of this entry and the index of the first entry of that term
+    // If not, -1 for the term and the size of the follower logs for the index
+    const int _conflict_term;
+    const int _conflict_index;
 };
\ No newline at end of file
@@ -2,22 +2,78 @@
 
 // ========== LogEntry class implementation ==========
 
-LogEntry::LogEntry(int term, std::string command) 
-    : _term(term), _command(command)
+LogEntry::LogEntry(int term, std::string command, int client_id, int sequence, int answered_sequence) 
+    : _term(term), _client_id(client_id), _sequence(sequence), _answered_sequence(answered_sequence), _command(std::move(command))
 {}
 
 LogEntry::LogEntry(const nlohmann::json& serialized_json) 
-    : LogEntry(serialized_json["term"], serialized_json["command"])
+    : LogEntry(serialized_json["term"], serialized_json["command"], serialized_json["client_id"], 
+               serialized_json["sequence"], serialized_json["answered_sequence"])
 {}
 
 LogEntry::LogEntry(const std::string& serialized) 
     : LogEntry(nlohmann::json::parse(serialized))
 {}
 
+LogEntry::LogEntry(BinaryReader& reader) 
+    : _term(reader.read_int32()), _client_id(reader.read_int32()), _sequence(reader.read_int32()), 
+      _answered_sequence(reader.read_int32()), _command(reader.read_string())
+{}
+
+LogEntry::LogEntry(const LogEntryView& entry_view) 
+    : _term(entry_view._term), _client_id(entry_view._client_id), _sequence(entry_view._sequence), 
+      _answered_sequence(entry_view._answered_sequence), _command(entry_view._command)
+{}
+
 nlohmann::json LogEntry::serialize_content() const
+{
+    return LogEntryView(*this).serialize_content();
+}
+
+void LogEntry::serialize_content(BinaryWriter& writer) const
+{
+    LogEntryView(*this).serialize_content(writer);
+}
+
+// ========== LogEntryView class implementation ==========
+
+LogEntryView::LogEntryView(int term, std::string_view command, int client_id, int sequence, int answered_sequence) 
+    : _term(term), _client_id(client_id), _sequence(sequence), _answered_sequence(answered_sequence), _command(command)
+{}
+
+LogEntryView::LogEntryView(const LogEntry& entry) 
+    : _term(entry._term), _client_id(entry._client_id), _sequence(entry._sequence), 
+      _answered_sequence(entry._answered_sequence), _command(entry._command)
+{}
+
+// The command is a view in the string of the JSON object, so the object must be kept alive while using the view
+LogEntryView::LogEntryView(const nlohmann::json& serialized_json) 
+    : _term(serialized_json["term"].get<int>()), _client_id(serialized_json["client_id"].get<int>()), 
+      _sequence(serialized_json["sequence"].get<int>()), _answered_sequence(serialized_json["answered_sequence"].get<int>()),
+      _command(serialized_json["command"].get_ref<const std::string&>())
+{}
+
+LogEntryView::LogEntryView(BinaryReader& reader) 
+    : _term(reader.read_int32()), _client_id(reader.read_int32()), _sequence(reader.read_int32()), 
+      _answered_sequence(reader.read_int32()), _command(reader.read_string_view())
+{}
+
+nlohmann::json LogEntryView::serialize_content() const
 {
     nlohmann::json json_object;
     json_object["term"] = this->_term;
+    json_object["client_id"] = this->_client_id;
+    json_object["sequence"] = this->_sequence;
+    json_object["answered_sequence"] = this->_answered_sequence;
     json_object["command"] = this->_command;
     return json_object;
-}
\ No newline at end of file
+}
+
+void LogEntryView::serialize_content(BinaryWriter& writer) const
+{
+    writer.write_int32(this->_term);
+    writer.write_int32(this->_client_id);
+    writer.write_int32(this->_sequence);
+    writer.write_int32(this->_answered_sequence);
+    writer.write_string(this->_command);
+}
@@ -1,22 +1,59 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <utility>
 
 #include "utils/json.hpp"
 #include "rpc/rpc.hpp"
+#include "rpc/codec/binary_codec.hpp"
+
+class LogEntryView;
 
 class LogEntry
 {
 public:
-    LogEntry(int term, std::string command);
+    LogEntry(int term, std::string command, int client_id = 0, int sequence = 0, int answered_sequence = 0);
     LogEntry(const nlohmann::json& serialized_json);
     LogEntry(const std::string& serialized);
+    LogEntry(BinaryReader& reader);
+    // Copy the command of the view, used when the entry is appended to the logs
+    LogEntry(const LogEntryView& entry_view);
 
     nlohmann::json serialize_content() const;
+    void serialize_content(BinaryWriter& writer) const;
 
     // The term of the server when handling the log entry
-    const int _term;
+    int _term;
+    // Session of the client that sent the entry (see ClientSessions), the client id is 0 for the entries without client (the no-op entries)
+    // Its sequence number, and the sequence number until which all the entries of the client were answered
+    int _client_id;
+    int _sequence;
+    int _answered_sequence;
     // The command of the log entry
-    const std::string _command;
-};
\ No newline at end of file
+    std::string _command;
+};
+
+// Log entry that does not own its command, used in the RPCs to avoid copying the commands
+// When received, the command is a view in the receive buffer (or the JSON object) of the Query
+// When sent, the command is a view in the LogEntry that is sent
+class LogEntryView
+{
+public:
+    LogEntryView(int term, std::string_view command, int client_id = 0, int sequence = 0, int answered_sequence = 0);
+    LogEntryView(const LogEntry& entry);
+    LogEntryView(const nlohmann::json& serialized_json);
+    LogEntryView(BinaryReader& reader);
+
+    nlohmann::json serialize_content() const;
+    void serialize_content(BinaryWriter& writer) const;
+
+    // The term of the server when handling the log entry
+    int _term;
+    // Session of the client that sent the entry (same as LogEntry)
+    int _client_id;
+    int _sequence;
+    int _answered_sequence;
+    // View on the command of the log entry
+    std::string_view _command;
+};
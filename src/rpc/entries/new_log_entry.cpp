@@ -3,43 +3,91 @@
 // ========== NewLogEntry class implementation ==========
 
 // Setting up the term to -1 as this is the response to the message and the term of the server won't be of any use for the client
-NewLogEntry::NewLogEntry(LogEntry log_entry) 
-    : RPC(-1, RPC::RPC_TYPE::NEW_LOG_ENTRY), _log_entry(log_entry)
+NewLogEntry::NewLogEntry(int request_id, std::vector<LogEntryView> log_entries) 
+    : RPC(-1, RPC::RPC_TYPE::NEW_LOG_ENTRY), _request_id(request_id), _log_entries(std::move(log_entries))
 {}
 
 NewLogEntry::NewLogEntry(const nlohmann::json& serialized_json) 
-    : NewLogEntry(LogEntry(serialized_json["log_entry"]))
-{}
+    : RPC(-1, RPC::RPC_TYPE::NEW_LOG_ENTRY), _request_id(serialized_json["request_id"])
+{
+    for (const auto& entry : serialized_json["log_entries"])
+        this->_log_entries.emplace_back(entry);
+}
 
-NewLogEntry::NewLogEntry(const std::string& serialized) 
-    : NewLogEntry(nlohmann::json::parse(serialized))
-{}
+NewLogEntry::NewLogEntry(BinaryReader& reader) 
+    : RPC(-1, RPC::RPC_TYPE::NEW_LOG_ENTRY), _request_id(reader.read_int32())
+{
+    const uint32_t entries_count = reader.read_uint32();
+    this->_log_entries.reserve(entries_count);
+    for (uint32_t i = 0; i < entries_count; i++)
+        this->_log_entries.emplace_back(reader);
+}
 
 nlohmann::json NewLogEntry::serialize_content() const
 {
     nlohmann::json json_object;
-    json_object["log_entry"] = this->_log_entry.serialize_content();
+    json_object["request_id"] = this->_request_id;
+    json_object["log_entries"] = nlohmann::json::array();
+    for (const LogEntryView& entry : this->_log_entries)
+    {
+        json_object["log_entries"].push_back(entry.serialize_content());
+    }
     return json_object;
 }
 
+void NewLogEntry::serialize_content(BinaryWriter& writer) const
+{
+    writer.write_int32(this->_request_id);
+    writer.write_uint32(this->_log_entries.size());
+    for (const LogEntryView& entry : this->_log_entries)
+    {
+        entry.serialize_content(writer);
+    }
+}
+
 // ========== NewLogEntryResponse class implementation ==========
 
 // Setting up the term to -1 as this is the response to the message and the term of the server won't be of any use for the client
-NewLogEntryResponse::NewLogEntryResponse(bool success) 
-    : RPC(-1, RPC::RPC_TYPE::NEW_LOG_ENTRY_RESPONSE), _success(success)
+NewLogEntryResponse::NewLogEntryResponse(int request_id, bool success, std::vector<std::string> results, int leader_hint) 
+    : RPC(-1, RPC::RPC_TYPE::NEW_LOG_ENTRY_RESPONSE), _request_id(request_id), _success(success), _results(std::move(results)), _leader_hint(leader_hint)
 {}
 
 NewLogEntryResponse::NewLogEntryResponse(const nlohmann::json& serialized_json) 
-    : NewLogEntryResponse(serialized_json["success"].get<bool>())
+    : NewLogEntryResponse(serialized_json["request_id"].get<int>(), serialized_json["success"].get<bool>(), 
+                          serialized_json["results"].get<std::vector<std::string>>(), serialized_json["leader_hint"].get<int>())
 {}
 
 NewLogEntryResponse::NewLogEntryResponse(const std::string& serialized) 
     : NewLogEntryResponse(nlohmann::json::parse(serialized))
 {}
 
+NewLogEntryResponse::NewLogEntryResponse(BinaryReader& reader) 
+    : RPC(-1, RPC::RPC_TYPE::NEW_LOG_ENTRY_RESPONSE), _request_id(reader.read_int32()), _success(reader.read_bool()), _leader_hint(reader.read_int32())
+{
+    const uint32_t results_count = reader.read_uint32();
+    this->_results.reserve(results_count);
+    for (uint32_t i = 0; i < results_count; i++)
+        this->_results.push_back(reader.read_string());
+}
+
 nlohmann::json NewLogEntryResponse::serialize_content() const
 {
     nlohmann::json json_object;
+    json_object["request_id"] = this->_request_id;
     json_object["success"] = this->_success;
+    json_object["results"] = this->_results;
+    json_object["leader_hint"] = this->_leader_hint;
     return json_object;
-}
\ No newline at end of file
+}
+
+void NewLogEntryResponse::serialize_content(BinaryWriter& writer) const
+{
+    writer.write_int32(this->_request_id);
+    writer.write_bool(this->_success);
+    writer.write_int32(this->_leader_hint);
+    writer.write_uint32(this->_results.size());
+    for (const std::string& result : this->_results)
+    {
+        writer.write_string(result);
+    }
+}
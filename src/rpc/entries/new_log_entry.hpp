@@ -1,32 +1,49 @@
 #pragma once
 
+#include <string>
+#include <vector>
+
 #include "rpc/rpc.hpp"
 #include "log_entry.hpp"
 
 class NewLogEntry : public RPC
 {
 public:
-    NewLogEntry(LogEntry entry);
+    NewLogEntry(int request_id, std::vector<LogEntryView> log_entries);
+    // The entries are views in the JSON object (or the reader data) so it must be kept alive while using them
     NewLogEntry(const nlohmann::json& serialized_json);
-    NewLogEntry(const std::string& serialized);
+    NewLogEntry(BinaryReader& reader);
 
     // Function used to serialize the class as a json to be sent later as a string
     nlohmann::json serialize_content() const override;
+    // Function used to pack the class in the binary format
+    void serialize_content(BinaryWriter& writer) const override;
 
-    // New LogEntry to add to the logs
-    LogEntry _log_entry;
+    // Identifier of the batch for the client, sent back with the response (the client may have several batches waiting for their response)
+    int _request_id;
+    // Batch of new LogEntry to add to the logs (in this order, they are all added at once)
+    std::vector<LogEntryView> _log_entries;
 };
 
 class NewLogEntryResponse : public RPC
 {
 public:
-    NewLogEntryResponse(bool success);
+    NewLogEntryResponse(int request_id, bool success, std::vector<std::string> results = std::vector<std::string>(), int leader_hint = 0);
     NewLogEntryResponse(const nlohmann::json& serialized_json);
     NewLogEntryResponse(const std::string& serialized);
+    NewLogEntryResponse(BinaryReader& reader);
 
     // Function used to serialize the class as a json to be sent later as a string
     nlohmann::json serialize_content() const override;
+    // Function used to pack the class in the binary format
+    void serialize_content(BinaryWriter& writer) const override;
 
-    // Reponse True if the entry has been added to the logs
+    // Identifier of the batch of the client
+    const int _request_id;
+    // Reponse True if the entries of the batch have been added to the logs
     const bool _success;
-};
\ No newline at end of file
+    // Result of the command of each entry of the batch once applied by the state machine of the servers
+    std::vector<std::string> _results;
+    // Rank of the leader known by the server that denied the entries (0 if it does not know it), the client sends the entries to it directly
+    const int _leader_hint;
+};
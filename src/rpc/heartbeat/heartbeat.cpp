@@ -2,12 +2,13 @@
 
 // ========== Heartbeat class implementation ==========
 
-Heartbeat::Heartbeat(int term, size_t leader_rank, int prev_log_index, int prev_log_term, int leader_commit)
+Heartbeat::Heartbeat(int term, size_t leader_rank, int prev_log_index, int prev_log_term, int leader_commit, int read_round)
     : RPC(term, RPC::RPC_TYPE::HEARTBEAT), 
       _leader_rank(leader_rank),
       _prev_log_index(prev_log_index), 
       _prev_log_term(prev_log_term), 
-      _leader_commit(leader_commit)
+      _leader_commit(leader_commit),
+      _read_round(read_round)
 {}
 
 Heartbeat::Heartbeat(int term, const nlohmann::json& serialized_json)
@@ -15,13 +16,23 @@ Heartbeat::Heartbeat(int term, const nlohmann::json& serialized_json)
       _leader_rank(serialized_json["leader_rank"]),
       _prev_log_index(serialized_json["prev_log_index"]), 
       _prev_log_term(serialized_json["prev_log_term"]), 
-      _leader_commit(serialized_json["leader_commit"])
+      _leader_commit(serialized_json["leader_commit"]),
+      _read_round(serialized_json["read_round"])
 {}
 
 Heartbeat::Heartbeat(int term, const std::string& serialized) 
     : Heartbeat(term, nlohmann::json::parse(serialized))
 {}
 
+Heartbeat::Heartbeat(int term, BinaryReader& reader)
+    : RPC(term, RPC::RPC_TYPE::HEARTBEAT), 
+      _leader_rank(reader.read_uint32()),
+      _prev_log_index(reader.read_int32()), 
+      _prev_log_term(reader.read_int32()), 
+      _leader_commit(reader.read_int32()),
+      _read_round(reader.read_int32())
+{}
+
 nlohmann::json Heartbeat::serialize_content() const
 {
     nlohmann::json json_object;
@@ -29,5 +40,48 @@ nlohmann::json Heartbeat::serialize_content() const
     json_object["prev_log_index"] = this->_prev_log_index;
     json_object["prev_log_term"] = this->_prev_log_term;
     json_object["leader_commit"] = this->_leader_commit;
+    json_object["read_round"] = this->_read_round;
+    return json_object;
+}
+
+void Heartbeat::serialize_content(BinaryWriter& writer) const
+{
+    writer.write_uint32(this->_leader_rank);
+    writer.write_int32(this->_prev_log_index);
+    writer.write_int32(this->_prev_log_term);
+    writer.write_int32(this->_leader_commit);
+    writer.write_int32(this->_read_round);
+}
+
+// ========== HeartbeatResponse class implementation ==========
+
+HeartbeatResponse::HeartbeatResponse(int term, int read_round)
+    : RPC(term, RPC::RPC_TYPE::HEARTBEAT_RESPONSE), 
+      _read_round(read_round)
+{}
+
+HeartbeatResponse::HeartbeatResponse(int term, const nlohmann::json& serialized_json)
+    : RPC(term, RPC::RPC_TYPE::HEARTBEAT_RESPONSE), 
+      _read_round(serialized_json["read_round"])
+{}
+
+HeartbeatResponse::HeartbeatResponse(int term, const std::string& serialized) 
+    : HeartbeatResponse(term, nlohmann::json::parse(serialized))
+{}
+
+HeartbeatResponse::HeartbeatResponse(int term, BinaryReader& reader)
+    : RPC(term, RPC::RPC_TYPE::HEARTBEAT_RESPONSE), 
+      _read_round(reader.read_int32())
+{}
+
+nlohmann::json HeartbeatResponse::serialize_content() const
+{
+    nlohmann::json json_object;
+    json_object["read_round"] = this->_read_round;
     return json_object;
+}
+
+void HeartbeatResponse::serialize_content(BinaryWriter& writer) const
+{
+    writer.write_int32(this->_read_round);
 }
\ No newline at end of file
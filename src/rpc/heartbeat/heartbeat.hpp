@@ -7,12 +7,15 @@
 class Heartbeat : public RPC
 {
 public:
-    Heartbeat(int term, size_t leader_rank, int prev_log_index, int prev_log_term, int leader_commit);
+    Heartbeat(int term, size_t leader_rank, int prev_log_index, int prev_log_term, int leader_commit, int read_round = 0);
     Heartbeat(int term, const nlohmann::json& serialized_json);
     Heartbeat(int term, const std::string& serialized);
+    Heartbeat(int term, BinaryReader& reader);
 
     // Function used to serialize the class as a json to be sent later as a string
     nlohmann::json serialize_content() const override;
+    // Function used to pack the class in the binary format
+    void serialize_content(BinaryWriter& writer) const override;
 
     // This is the same data as AppendEntries (we just have no entries)
     // This is to make sure that the server receiving the heartbeat is up to date
@@ -20,4 +23,23 @@ public:
     const int _prev_log_index;
     const int _prev_log_term;
     const int _leader_commit;
+    // Round of reads confirmed by this heartbeat (see ReadIndex in the server), the followers only answer the heartbeats with a round
+    const int _read_round;
+};
+
+class HeartbeatResponse : public RPC
+{
+public:
+    HeartbeatResponse(int term, int read_round);
+    HeartbeatResponse(int term, const nlohmann::json& serialized_json);
+    HeartbeatResponse(int term, const std::string& serialized);
+    HeartbeatResponse(int term, BinaryReader& reader);
+
+    // Function used to serialize the class as a json to be sent later as a string
+    nlohmann::json serialize_content() const override;
+    // Function used to pack the class in the binary format
+    void serialize_content(BinaryWriter& writer) const override;
+
+    // Round of reads of the heartbeat (the follower still considers the sender as the leader of the term when it sent the heartbeat)
+    const int _read_round;
 };
\ No newline at end of file
@@ -15,6 +15,10 @@ SearchLeader::SearchLeader(const std::string& serialized)
     : SearchLeader(nlohmann::json::parse(serialized))
 {}
 
+SearchLeader::SearchLeader(BinaryReader& reader) 
+    : SearchLeader(reader.read_int32())
+{}
+
 nlohmann::json SearchLeader::serialize_content() const
 {
     nlohmann::json json_object;
@@ -22,6 +26,11 @@ nlohmann::json SearchLeader::serialize_content() const
     return json_object;
 }
 
+void SearchLeader::serialize_content(BinaryWriter& writer) const
+{
+    writer.write_int32(this->_leader_rank);
+}
+
 // ========== SearchLeaderResponse class implementation ==========
 
 // Setting the term to -1 as this is not a request that will be used by servers
@@ -37,9 +46,18 @@ SearchLeaderResponse::SearchLeaderResponse(const std::string& serialized)
     : SearchLeaderResponse(nlohmann::json::parse(serialized))
 {}
 
+SearchLeaderResponse::SearchLeaderResponse(BinaryReader& reader) 
+    : SearchLeaderResponse(reader.read_int32())
+{}
+
 nlohmann::json SearchLeaderResponse::serialize_content() const
 {
     nlohmann::json json_object;
     json_object["leader_rank"] = this->_leader_rank;
     return json_object;
+}
+
+void SearchLeaderResponse::serialize_content(BinaryWriter& writer) const
+{
+    writer.write_int32(this->_leader_rank);
 }
\ No newline at end of file
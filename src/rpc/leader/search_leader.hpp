@@ -8,9 +8,12 @@ public:
     SearchLeader(const int leader_rank);
     SearchLeader(const nlohmann::json& serialized_json);
     SearchLeader(const std::string& serialized);
+    SearchLeader(BinaryReader& reader);
 
     // Function used to serialize the class as a json to be sent later as a string
     nlohmann::json serialize_content() const override;
+    // Function used to pack the class in the binary format
+    void serialize_content(BinaryWriter& writer) const override;
 
     // Rank of the last known leader before sending that query
     int _leader_rank;
@@ -22,9 +25,12 @@ public:
     SearchLeaderResponse(const int leader_rank);
     SearchLeaderResponse(const nlohmann::json& serialized_json);
     SearchLeaderResponse(const std::string& serialized);
+    SearchLeaderResponse(BinaryReader& reader);
 
     // Function used to serialize the class as a json to be sent later as a string
     nlohmann::json serialize_content() const override;
+    // Function used to pack the class in the binary format
+    void serialize_content(BinaryWriter& writer) const override;
 
     // Rank of the current leader
     const int _leader_rank;
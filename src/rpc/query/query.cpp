@@ -2,8 +2,9 @@
 
 // ========== Query Class implementation ==========
 
-Query::Query(size_t source_rank, RPC::RPC_TYPE type, int term, request_content content)
+Query::Query(size_t source_rank, RPC::RPC_TYPE type, int term, request_content content, std::shared_ptr<const void> buffer)
     : _source_rank(source_rank), 
       _type(type), _term(term), 
-      _content(content)
+      _content(std::move(content)),
+      _buffer(std::move(buffer))
 {}
\ No newline at end of file
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <memory>
 #include <variant>
 
 #include "rpc/rpc.hpp"
@@ -9,6 +10,9 @@
 #include "rpc/leader/search_leader.hpp"
 #include "rpc/entries/append_entries.hpp"
 #include "rpc/entries/new_log_entry.hpp"
+#include "rpc/snapshot/install_snapshot.hpp"
+#include "rpc/read/read_request.hpp"
+#include "rpc/read/read_index.hpp"
 
 // ========== Query Class ==========
 
@@ -17,15 +21,18 @@ class Query
 public:
     // Using this type for easier reading 
     // Here we are using variant as the type used here will be one of those passed in parameters
-    using request_content = std::variant<Heartbeat,
+    using request_content = std::variant<Heartbeat, HeartbeatResponse,
                                          VoteRequest, VoteResponse,
                                          AppendEntries, AppendEntriesResponse,
+                                         InstallSnapshot, InstallSnapshotResponse,
                                          NewLogEntry, NewLogEntryResponse,
+                                         ReadRequest, ReadResponse,
+                                         ReadIndexRequest, ReadIndexResponse,
                                          SearchLeader, SearchLeaderResponse,
                                          Message, MessageResponse
                                         >;
     
-    Query(size_t source_rank, RPC::RPC_TYPE type, int term, request_content content);
+    Query(size_t source_rank, RPC::RPC_TYPE type, int term, request_content content, std::shared_ptr<const void> buffer = nullptr);
 
     // Rank of the source server Source rank
     const size_t _source_rank;
@@ -35,4 +42,7 @@ public:
     const int _term;
     // Content of the Query
     const request_content _content;
+    // Data from which the Query was decoded (receive buffer or JSON object)
+    // As the log entries of the content are views in it, it is kept alive as long as the Query is alive
+    const std::shared_ptr<const void> _buffer;
 };
\ No newline at end of file
@@ -0,0 +1,72 @@
+#include "read_index.hpp"
+
+// ========== ReadIndexRequest class implementation ==========
+
+ReadIndexRequest::ReadIndexRequest(int term, int read_round)
+    : RPC(term, RPC::RPC_TYPE::READ_INDEX_REQUEST), 
+      _read_round(read_round)
+{}
+
+ReadIndexRequest::ReadIndexRequest(int term, const nlohmann::json& serialized_json)
+    : RPC(term, RPC::RPC_TYPE::READ_INDEX_REQUEST), 
+      _read_round(serialized_json["read_round"])
+{}
+
+ReadIndexRequest::ReadIndexRequest(int term, const std::string& serialized) 
+    : ReadIndexRequest(term, nlohmann::json::parse(serialized))
+{}
+
+ReadIndexRequest::ReadIndexRequest(int term, BinaryReader& reader)
+    : RPC(term, RPC::RPC_TYPE::READ_INDEX_REQUEST), 
+      _read_round(reader.read_int32())
+{}
+
+nlohmann::json ReadIndexRequest::serialize_content() const
+{
+    nlohmann::json json_object;
+    json_object["read_round"] = this->_read_round;
+    return json_object;
+}
+
+void ReadIndexRequest::serialize_content(BinaryWriter& writer) const
+{
+    writer.write_int32(this->_read_round);
+}
+
+// ========== ReadIndexResponse class implementation ==========
+
+ReadIndexResponse::ReadIndexResponse(int term, int read_round, int read_index)
+    : RPC(term, RPC::RPC_TYPE::READ_INDEX_RESPONSE), 
+      _read_round(read_round),
+      _read_index(read_index)
+{}
+
+ReadIndexResponse::ReadIndexResponse(int term, const nlohmann::json& serialized_json)
+    : RPC(term, RPC::RPC_TYPE::READ_INDEX_RESPONSE), 
+      _read_round(serialized_json["read_round"]),
+      _read_index(serialized_json["read_index"])
+{}
+
+ReadIndexResponse::ReadIndexResponse(int term, const std::string& serialized) 
+    : ReadIndexResponse(term, nlohmann::json::parse(serialized))
+{}
+
+ReadIndexResponse::ReadIndexResponse(int term, BinaryReader& reader)
+    : RPC(term, RPC::RPC_TYPE::READ_INDEX_RESPONSE), 
+      _read_round(reader.read_int32()),
+      _read_index(reader.read_int32())
+{}
+
+nlohmann::json ReadIndexResponse::serialize_content() const
+{
+    nlohmann::json json_object;
+    json_object["read_round"] = this->_read_round;
+    json_object["read_index"] = this->_read_index;
+    return json_object;
+}
+
+void ReadIndexResponse::serialize_content(BinaryWriter& writer) const
+{
+    writer.write_int32(this->_read_round);
+    writer.write_int32(this->_read_index);
+}
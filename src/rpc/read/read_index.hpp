@@ -0,0 +1,39 @@
+#pragma once
+
+#include "rpc/rpc.hpp"
+
+class ReadIndexRequest : public RPC
+{
+public:
+    ReadIndexRequest(int term, int read_round);
+    ReadIndexRequest(int term, const nlohmann::json& serialized_json);
+    ReadIndexRequest(int term, const std::string& serialized);
+    ReadIndexRequest(int term, BinaryReader& reader);
+
+    // Function used to serialize the class as a json to be sent later as a string
+    nlohmann::json serialize_content() const override;
+    // Function used to pack the class in the binary format
+    void serialize_content(BinaryWriter& writer) const override;
+
+    // Identifier of the request for the follower, shared by all the reads of the follower waiting for this read index
+    const int _read_round;
+};
+
+class ReadIndexResponse : public RPC
+{
+public:
+    ReadIndexResponse(int term, int read_round, int read_index);
+    ReadIndexResponse(int term, const nlohmann::json& serialized_json);
+    ReadIndexResponse(int term, const std::string& serialized);
+    ReadIndexResponse(int term, BinaryReader& reader);
+
+    // Function used to serialize the class as a json to be sent later as a string
+    nlohmann::json serialize_content() const override;
+    // Function used to pack the class in the binary format
+    void serialize_content(BinaryWriter& writer) const override;
+
+    // Identifier of the request of the follower
+    const int _read_round;
+    // Commit index of the leader once its leadership is confirmed, the reads of the request are answered once it is applied by the follower
+    const int _read_index;
+};
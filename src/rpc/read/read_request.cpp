@@ -0,0 +1,72 @@
+#include "read_request.hpp"
+
+// ========== ReadRequest class implementation ==========
+
+// Setting up the term to -1 as this is a query of a client, which has no term
+ReadRequest::ReadRequest(int request_id, std::string_view query, bool stale) 
+    : RPC(-1, RPC::RPC_TYPE::READ_REQUEST), _request_id(request_id), _query(query), _stale(stale)
+{}
+
+ReadRequest::ReadRequest(const nlohmann::json& serialized_json) 
+    : ReadRequest(serialized_json["request_id"].get<int>(), std::string_view(serialized_json["query"].get_ref<const std::string&>()), 
+                  serialized_json["stale"].get<bool>())
+{}
+
+ReadRequest::ReadRequest(BinaryReader& reader) 
+    : RPC(-1, RPC::RPC_TYPE::READ_REQUEST), _request_id(reader.read_int32()), _query(reader.read_string_view()), _stale(reader.read_bool())
+{}
+
+nlohmann::json ReadRequest::serialize_content() const
+{
+    nlohmann::json json_object;
+    json_object["request_id"] = this->_request_id;
+    json_object["query"] = this->_query;
+    json_object["stale"] = this->_stale;
+    return json_object;
+}
+
+void ReadRequest::serialize_content(BinaryWriter& writer) const
+{
+    writer.write_int32(this->_request_id);
+    writer.write_string(this->_query);
+    writer.write_bool(this->_stale);
+}
+
+// ========== ReadResponse class implementation ==========
+
+// Setting up the term to -1 as this is the response to a client and the term of the server won't be of any use for it
+ReadResponse::ReadResponse(int request_id, bool success, std::string result, int leader_hint) 
+    : RPC(-1, RPC::RPC_TYPE::READ_RESPONSE), _request_id(request_id), _success(success), _result(std::move(result)), _leader_hint(leader_hint)
+{}
+
+ReadResponse::ReadResponse(const nlohmann::json& serialized_json) 
+    : ReadResponse(serialized_json["request_id"].get<int>(), serialized_json["success"].get<bool>(), serialized_json["result"].get<std::string>(),
+                   serialized_json["leader_hint"].get<int>())
+{}
+
+ReadResponse::ReadResponse(const std::string& serialized) 
+    : ReadResponse(nlohmann::json::parse(serialized))
+{}
+
+ReadResponse::ReadResponse(BinaryReader& reader) 
+    : RPC(-1, RPC::RPC_TYPE::READ_RESPONSE), _request_id(reader.read_int32()), _success(reader.read_bool()), _result(reader.read_string()),
+      _leader_hint(reader.read_int32())
+{}
+
+nlohmann::json ReadResponse::serialize_content() const
+{
+    nlohmann::json json_object;
+    json_object["request_id"] = this->_request_id;
+    json_object["success"] = this->_success;
+    json_object["result"] = this->_result;
+    json_object["leader_hint"] = this->_leader_hint;
+    return json_object;
+}
+
+void ReadResponse::serialize_content(BinaryWriter& writer) const
+{
+    writer.write_int32(this->_request_id);
+    writer.write_bool(this->_success);
+    writer.write_string(this->_result);
+    writer.write_int32(this->_leader_hint);
+}
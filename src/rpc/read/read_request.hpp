@@ -0,0 +1,51 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+
+#include "rpc/rpc.hpp"
+
+class ReadRequest : public RPC
+{
+public:
+    // The query is not copied, so it must be kept alive while the RPC is alive
+    ReadRequest(int request_id, std::string_view query, bool stale = false);
+    // The query is a view in the JSON object (or the reader data) so it must be kept alive while using it
+    ReadRequest(const nlohmann::json& serialized_json);
+    ReadRequest(BinaryReader& reader);
+
+    // Function used to serialize the class as a json to be sent later as a string
+    nlohmann::json serialize_content() const override;
+    // Function used to pack the class in the binary format
+    void serialize_content(BinaryWriter& writer) const override;
+
+    // Identifier of the read for the client, sent back with the response
+    const int _request_id;
+    // Query read from the state machine of the servers (it is not added to the logs)
+    const std::string_view _query;
+    // If true, the query can be read by a follower whose state is not older than the maximum staleness (see the follower reads)
+    const bool _stale;
+};
+
+class ReadResponse : public RPC
+{
+public:
+    ReadResponse(int request_id, bool success, std::string result = std::string(), int leader_hint = 0);
+    ReadResponse(const nlohmann::json& serialized_json);
+    ReadResponse(const std::string& serialized);
+    ReadResponse(BinaryReader& reader);
+
+    // Function used to serialize the class as a json to be sent later as a string
+    nlohmann::json serialize_content() const override;
+    // Function used to pack the class in the binary format
+    void serialize_content(BinaryWriter& writer) const override;
+
+    // Identifier of the read of the client
+    const int _request_id;
+    // Reponse True if the query has been read by the leader
+    const bool _success;
+    // Result of the query
+    const std::string _result;
+    // Rank of the leader known by the server that denied the read (0 if it does not know it), the client sends the read to it directly
+    const int _leader_hint;
+};
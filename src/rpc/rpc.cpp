@@ -2,6 +2,8 @@
 
 // ========== RCP TypeClass implementation ==========
 
+RPC::WIRE_FORMAT RPC::_wire_format = RPC::WIRE_FORMAT::BINARY;
+
 RPC::RPC(int term, RPC_TYPE rpc_type)
     : _term(term)
     , _rpc_type(rpc_type)
@@ -9,9 +11,40 @@ RPC::RPC(int term, RPC_TYPE rpc_type)
 
 std::string RPC::serialize() const
 {
-    nlohmann::json json_object;
-    json_object["message_type"] = this->_rpc_type;
-    json_object["term"] = this->_term;
-    json_object["message_content"] = this->serialize_content();
-    return json_object.dump();
-}
\ No newline at end of file
+    return this->serialize(RPC::_wire_format);
+}
+
+std::string RPC::serialize(WIRE_FORMAT wire_format) const
+{
+    if (wire_format == WIRE_FORMAT::JSON)
+    {
+        nlohmann::json json_object;
+        json_object["message_type"] = this->_rpc_type;
+        json_object["term"] = this->_term;
+        json_object["message_content"] = this->serialize_content();
+        return json_object.dump();
+    }
+
+    // Writing the header with an empty length as we only know it once the content is written
+    std::string serialized;
+    BinaryWriter writer = BinaryWriter(serialized);
+    writer.write_uint8(BinaryCodec::MAGIC);
+    writer.write_uint8(this->_rpc_type);
+    writer.write_int32(this->_term);
+    const size_t length_position = writer.position();
+    writer.write_uint32(0);
+
+    this->serialize_content(writer);
+    writer.patch_uint32(length_position, serialized.size() - BinaryCodec::HEADER_SIZE);
+    return serialized;
+}
+
+void RPC::set_wire_format(WIRE_FORMAT wire_format)
+{
+    RPC::_wire_format = wire_format;
+}
+
+RPC::WIRE_FORMAT RPC::get_wire_format()
+{
+    return RPC::_wire_format;
+}
@@ -4,6 +4,7 @@
 #include <utility>
 
 #include "utils/json.hpp"
+#include "rpc/codec/binary_codec.hpp"
 
 // ========== RCP TypeClass ==========
 
@@ -13,26 +14,48 @@ public:
     // Enum used to determine the type of RPC used 
     enum RPC_TYPE
     {
-        HEARTBEAT,
+        HEARTBEAT, HEARTBEAT_RESPONSE,
         VOTE_REQUEST, VOTE_RESPONSE,
         APPEND_ENTRIES, APPEND_ENTRIES_RESPONSE,
+        INSTALL_SNAPSHOT, INSTALL_SNAPSHOT_RESPONSE,
         NEW_LOG_ENTRY, NEW_LOG_ENTRY_RESPONSE,
+        READ_REQUEST, READ_RESPONSE,
+        READ_INDEX_REQUEST, READ_INDEX_RESPONSE,
         SEARCH_LEADER, SEARCH_LEADER_RESPONSE,
         MESSAGE, MESSAGE_RESPONSE,
         STATE_REQUEST, STATE_RESPONSE,
     };
 
+    // Enum used to determine the encoding of the RPC when it is sent
+    // The JSON format is slower and bigger, it is only kept to debug the messages
+    enum WIRE_FORMAT
+    {
+        BINARY,
+        JSON,
+    };
+
     // RPC Constructor with the term of the server and the type of RPC
     RPC(int term, RPC_TYPE rpc_type);
 
-    // Function used to serialize the RPC to a string ready to be sent to other servers
+    // Function used to serialize the RPC to a string ready to be sent to other servers (using the current wire format)
     std::string serialize() const;
+    std::string serialize(WIRE_FORMAT wire_format) const;
 
     // Virtual class that the inheritant classes will have to implement to parse their content
     virtual nlohmann::json serialize_content() const = 0;
+    // Virtual class that the inheritant classes will have to implement to pack their content in the binary format
+    virtual void serialize_content(BinaryWriter& writer) const = 0;
+
+    // Functions used to set up the wire format used by the process when sending RPCs
+    static void set_wire_format(WIRE_FORMAT wire_format);
+    static WIRE_FORMAT get_wire_format();
 
     // term of the RPC
     const int _term;
     // Type of the rpc
     const RPC_TYPE _rpc_type;
-};
\ No newline at end of file
+
+private:
+    // Wire format used by the process (binary by default)
+    static WIRE_FORMAT _wire_format;
+};
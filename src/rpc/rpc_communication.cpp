@@ -33,81 +33,127 @@ void send_to_all_processes(size_t source, size_t n_process, size_t offset, const
 
 // ========== RECEIVE FUNCTIONS ==========
 
-// Function used to generate the received query
-std::optional<Query> generate_query(const size_t source, const nlohmann::json& json_response) 
+// Function used to build the query from its content, the content being either a json object or a binary reader
+// (all the RPC classes have a constructor for both of them)
+template <typename Content>
+static std::optional<Query> build_query(const size_t source, RPC::RPC_TYPE message_type, int term, Content& message_content, const std::shared_ptr<const void>& buffer)
 {
-    RPC::RPC_TYPE message_type = json_response["message_type"].get<RPC::RPC_TYPE>();
-    size_t term = json_response["term"].get<size_t>();
-    // Migth be std::string for some so be carreful with this one ! (to maybe use in auto)
-    nlohmann::json message_content = json_response["message_content"];
-
     switch (message_type)
     {
         case RPC::RPC_TYPE::HEARTBEAT:
-            return std::make_optional<Query>(source, message_type, term, Heartbeat(term, message_content));
+            return std::make_optional<Query>(source, message_type, term, Heartbeat(term, message_content), buffer);
+
+        case RPC::RPC_TYPE::HEARTBEAT_RESPONSE:
+            return std::make_optional<Query>(source, message_type, term, HeartbeatResponse(term, message_content), buffer);
 
         case RPC::RPC_TYPE::VOTE_REQUEST:
-            return std::make_optional<Query>(source, message_type, term, VoteRequest(term, message_content));
+            return std::make_optional<Query>(source, message_type, term, VoteRequest(term, message_content), buffer);
 
         case RPC::RPC_TYPE::VOTE_RESPONSE:
-            return std::make_optional<Query>(source, message_type, term, VoteResponse(term, message_content));
+            return std::make_optional<Query>(source, message_type, term, VoteResponse(term, message_content), buffer);
 
         case RPC::RPC_TYPE::APPEND_ENTRIES: 
-            return std::make_optional<Query>(source, message_type, term, AppendEntries(term, message_content));
+            return std::make_optional<Query>(source, message_type, term, AppendEntries(term, message_content), buffer);
 
         case RPC::RPC_TYPE::APPEND_ENTRIES_RESPONSE: 
-            return std::make_optional<Query>(source, message_type, term, AppendEntriesResponse(term, message_content));
+            return std::make_optional<Query>(source, message_type, term, AppendEntriesResponse(term, message_content), buffer);
+
+        case RPC::RPC_TYPE::INSTALL_SNAPSHOT: 
+            return std::make_optional<Query>(source, message_type, term, InstallSnapshot(term, message_content), buffer);
+
+        case RPC::RPC_TYPE::INSTALL_SNAPSHOT_RESPONSE: 
+            return std::make_optional<Query>(source, message_type, term, InstallSnapshotResponse(term, message_content), buffer);
 
         // From this part, the next type of RPC won't have any term type as they are made to be used by the clients
 
         case RPC::RPC_TYPE::NEW_LOG_ENTRY: 
-            return std::make_optional<Query>(source, message_type, term, NewLogEntry(message_content));
+            return std::make_optional<Query>(source, message_type, term, NewLogEntry(message_content), buffer);
 
         case RPC::RPC_TYPE::NEW_LOG_ENTRY_RESPONSE: 
-            return std::make_optional<Query>(source, message_type, term, NewLogEntryResponse(message_content));
+            return std::make_optional<Query>(source, message_type, term, NewLogEntryResponse(message_content), buffer);
+
+        case RPC::RPC_TYPE::READ_REQUEST: 
+            return std::make_optional<Query>(source, message_type, term, ReadRequest(message_content), buffer);
+
+        case RPC::RPC_TYPE::READ_RESPONSE: 
+            return std::make_optional<Query>(source, message_type, term, ReadResponse(message_content), buffer);
+
+        case RPC::RPC_TYPE::READ_INDEX_REQUEST: 
+            return std::make_optional<Query>(source, message_type, term, ReadIndexRequest(term, message_content), buffer);
+
+        case RPC::RPC_TYPE::READ_INDEX_RESPONSE: 
+            return std::make_optional<Query>(source, message_type, term, ReadIndexResponse(term, message_content), buffer);
 
         case RPC::RPC_TYPE::SEARCH_LEADER: 
-            return std::make_optional<Query>(source, message_type, term, SearchLeader(message_content));
+            return std::make_optional<Query>(source, message_type, term, SearchLeader(message_content), buffer);
 
         case RPC::RPC_TYPE::SEARCH_LEADER_RESPONSE: 
-            return std::make_optional<Query>(source, message_type, term, SearchLeaderResponse(message_content));
+            return std::make_optional<Query>(source, message_type, term, SearchLeaderResponse(message_content), buffer);
 
         case RPC::RPC_TYPE::MESSAGE:
-            return std::make_optional<Query>(source, message_type, term, Message(message_content));
+            return std::make_optional<Query>(source, message_type, term, Message(message_content), buffer);
 
         case RPC::RPC_TYPE::MESSAGE_RESPONSE:
-            return std::make_optional<Query>(source, message_type, term, MessageResponse(message_content));
+            return std::make_optional<Query>(source, message_type, term, MessageResponse(message_content), buffer);
 
         default:
             return std::nullopt;
     }
 }
 
-// Function used to receive a single message from the source server
-std::optional<Query> receive_message(size_t source, int tag)
+// Function used to generate the received query from a JSON message
+// The buffer is the owner of the JSON object (the log entries of the query are views in it)
+std::optional<Query> generate_query(const size_t source, const nlohmann::json& json_response, std::shared_ptr<const void> buffer) 
 {
-    MPI_Status mpi_status;
+    RPC::RPC_TYPE message_type = json_response["message_type"].get<RPC::RPC_TYPE>();
+    size_t term = json_response["term"].get<size_t>();
+    // Migth be std::string for some so be carreful with this one ! (to maybe use in auto)
+    const nlohmann::json& message_content = json_response["message_content"];
 
-    int flag;
-    MPI_Iprobe(source, tag, MPI_COMM_WORLD, &flag, &mpi_status);
+    return build_query(source, message_type, term, message_content, buffer);
+}
 
-    if (!flag)
+// Function used to generate the received query from a binary message (the reader must be at the start of the header)
+// The buffer is the owner of the data read by the reader (the log entries of the query are views in it)
+std::optional<Query> generate_query(const size_t source, BinaryReader& reader, std::shared_ptr<const void> buffer) 
+{
+    if (reader.read_uint8() != BinaryCodec::MAGIC)
     {
         return std::nullopt;
     }
+    RPC::RPC_TYPE message_type = (RPC::RPC_TYPE)reader.read_uint8();
+    int term = reader.read_int32();
 
-    int buffer_size = 0;
-    MPI_Get_count(&mpi_status, MPI_CHAR, &buffer_size);
+    // Checking that the length of the payload is the same as the one written in the header
+    if (reader.read_uint32() != reader.remaining())
+    {
+        return std::nullopt;
+    }
 
-    std::vector<char> buffer(buffer_size);
-    MPI_Recv(buffer.data(), buffer_size, MPI_CHAR, source, tag, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+    return build_query(source, message_type, term, reader, buffer);
+}
 
-    std::string serialized_response(buffer.begin(), buffer.end());
+// Function used to decode a received message, the format is found with the first byte of the message
+// (a JSON message always starts with '{' and a binary message with the magic byte)
+// The buffer is the owner of the data, it is kept by the Query as the binary messages are decoded without copying the commands
+std::optional<Query> decode_query(const size_t source, const char* data, size_t size, std::shared_ptr<const void> buffer)
+{
+    if (size == 0)
+    {
+        return std::nullopt;
+    }
 
     try 
     {
-        nlohmann::json json_response = nlohmann::json::parse(serialized_response);
-        return generate_query(source, json_response);
+        if ((uint8_t)data[0] == BinaryCodec::MAGIC)
+        {
+            BinaryReader reader = BinaryReader(data, size);
+            return generate_query(source, reader, std::move(buffer));
+        }
+
+        // For the JSON messages, the query is keeping the JSON object as the commands are views in it
+        auto json_response = std::make_shared<const nlohmann::json>(nlohmann::json::parse(data, data + size));
+        return generate_query(source, *json_response, json_response);
     }
     catch (...)
     {
@@ -115,33 +161,81 @@ std::optional<Query> receive_message(size_t source, int tag)
     }
 }
 
-// Here there are some little things to catch : 
-// This function is used to receive queries to all the n_process processes since the offset
-// The process_rank is the rank of the process receiving the queries
-// The n_process is here to determine the number of ranks from which we want to receive the queries
-// The offset is here to determine the start rank from which we receive the queries
-void receive_all_messages(size_t process_rank, size_t n_process, size_t offset, std::vector<Query>& queries, int tag)
+// Function used to receive the message matched by a probe (a matched message can only be received with its handle, by this process)
+static std::optional<Query> receive_matched_message(MPI_Message& message, MPI_Status& mpi_status)
 {
-    for (size_t rank = 0; rank < n_process; rank++)
+    int buffer_size = 0;
+    MPI_Get_count(&mpi_status, MPI_CHAR, &buffer_size);
+
+    // Receiving the message in a buffer of the pool, the query is decoded directly from it
+    ReceiveBufferPool::Buffer buffer = ReceiveBufferPool::acquire(buffer_size);
+    MPI_Mrecv(buffer->data(), buffer_size, MPI_CHAR, &message, MPI_STATUS_IGNORE);
+
+    return decode_query(mpi_status.MPI_SOURCE, buffer->data(), buffer->size(), buffer);
+}
+
+// Function used to receive a single message from the source server
+std::optional<Query> receive_message(size_t source, int tag)
+{
+    MPI_Status mpi_status;
+    MPI_Message message;
+
+    int flag;
+    MPI_Improbe(source, tag, MPI_COMM_WORLD, &flag, &message, &mpi_status);
+
+    if (!flag)
+    {
+        return std::nullopt;
+    }
+    return receive_matched_message(message, mpi_status);
+}
+
+// Function used to receive the messages that arrived from any process, in their order of arrival
+// The messages are matched with a single probe on any source, so the cost only depends on the number of received messages (not on the number of processes)
+// At most max_messages are received, the other ones are received by the next call (so that a process is not kept receiving by a flood of messages)
+void receive_all_messages(std::vector<Query>& queries, int tag, size_t max_messages)
+{
+    for (size_t received = 0; received < max_messages; received++)
+    {
+        MPI_Status mpi_status;
+        MPI_Message message;
+
+        int flag;
+        MPI_Improbe(MPI_ANY_SOURCE, tag, MPI_COMM_WORLD, &flag, &message, &mpi_status);
+        if (!flag)
+        {
+            break;
+        }
+
+        std::optional<Query> query = receive_matched_message(message, mpi_status);
+        if (query.has_value())
+        {
+            queries.emplace_back(std::move(query.value()));
+        }
+    }
+}
+
+// MPI has no probe blocking with a timeout, so the probe is done again after a short sleep until a message arrives or the timeout is over
+// With the busy polling, the probe is done again without sleeping, which lowers the latency but keeps the core busy
+bool wait_for_message(int tag, float timeout, int poll_interval)
+{
+    // MPI has no blocking probe with a timeout, so the messages are probed until one comes or the timeout is over
+    Clock clock;
+    int flag = 0;
+    while (true)
     {
-        // Setting up the real source rank (as the client_offset is the rank of the last client)
-        size_t source_rank = rank + offset;
-        // If the source is the same as the server rank, then skip
-        if (source_rank == process_rank)
-            continue;
-
-        // Loop used to receive all the message from each server
-        while (true)
+        MPI_Iprobe(MPI_ANY_SOURCE, tag, MPI_COMM_WORLD, &flag, MPI_STATUS_IGNORE);
+        if (flag)
         {
-            std::optional<Query> query = receive_message(source_rank, tag);
-            if (query.has_value())
-            {
-                queries.emplace_back(query.value());
-            }
-            else
-            {
-                break;
-            }
+            return true;
+        }
+        if (clock.check_microseconds() >= timeout * 1000)
+        {
+            return false;
+        }
+        if (poll_interval > 0)
+        {
+            std::this_thread::sleep_for(std::chrono::microseconds(poll_interval));
         }
     }
-}
\ No newline at end of file
+}
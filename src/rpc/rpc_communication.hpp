@@ -5,6 +5,7 @@
 
 #include "mpi.h"
 #include "query/query.hpp"
+#include "buffer/receive_buffer_pool.hpp"
 #include "clock/clock.hpp"
 
 // ========== Communication functions implementation ==========
@@ -14,8 +15,15 @@ void send_message(const RPC& rpc_message, size_t destination, int tag);
 void send_to_all_processes(size_t source, size_t n_servers, size_t clients_offset, const RPC& rpc_message, int tag);
 
 // Generate Query 
-std::optional<Query> generate_query(const size_t source, const nlohmann::json& json_response);
+std::optional<Query> generate_query(const size_t source, const nlohmann::json& json_response, std::shared_ptr<const void> buffer = nullptr);
+std::optional<Query> generate_query(const size_t source, BinaryReader& reader, std::shared_ptr<const void> buffer = nullptr);
+// Decode a received message (binary or JSON) and generate the Query from it
+std::optional<Query> decode_query(const size_t source, const char* data, size_t size, std::shared_ptr<const void> buffer = nullptr);
 
 // Receive functions
 std::optional<Query> receive_message(size_t source, int tag);
-void receive_all_messages(size_t server_rank, size_t n_servers, size_t clients_offset, std::vector<Query>& queries, int tag);
\ No newline at end of file
+// Receive at most max_messages messages from any process (in their order of arrival)
+void receive_all_messages(std::vector<Query>& queries, int tag, size_t max_messages);
+// Wait until a message from any process can be received, or until the timeout (in milliseconds) is over (returns false on timeout)
+// The messages are probed every poll interval (in microseconds), or again without sleeping if it is 0 (busy polling)
+bool wait_for_message(int tag, float timeout, int poll_interval);
\ No newline at end of file
@@ -0,0 +1,103 @@
+#include "install_snapshot.hpp"
+
+// ========== InstallSnapshot class implementation ==========
+
+InstallSnapshot::InstallSnapshot(int term, size_t leader_rank, int last_included_index, int last_included_term, size_t offset, bool done, uint32_t crc, std::string_view data)
+    : RPC(term, RPC::RPC_TYPE::INSTALL_SNAPSHOT), 
+      _leader_rank(leader_rank),
+      _last_included_index(last_included_index), 
+      _last_included_term(last_included_term), 
+      _offset(offset),
+      _done(done),
+      _crc(crc),
+      _data(data)
+{}
+
+InstallSnapshot::InstallSnapshot(int term, const nlohmann::json& serialized_json)
+    : RPC(term, RPC::RPC_TYPE::INSTALL_SNAPSHOT), 
+      _leader_rank(serialized_json["leader_rank"]),
+      _last_included_index(serialized_json["last_included_index"]), 
+      _last_included_term(serialized_json["last_included_term"]), 
+      _offset(serialized_json["offset"]),
+      _done(serialized_json["done"]),
+      _crc(serialized_json["crc"]),
+      _data(serialized_json["data"].get_ref<const std::string&>())
+{}
+
+InstallSnapshot::InstallSnapshot(int term, BinaryReader& reader)
+    : RPC(term, RPC::RPC_TYPE::INSTALL_SNAPSHOT), 
+      _leader_rank(reader.read_uint32()),
+      _last_included_index(reader.read_int32()), 
+      _last_included_term(reader.read_int32()), 
+      _offset(reader.read_uint32()),
+      _done(reader.read_bool()),
+      _crc(reader.read_uint32()),
+      _data(reader.read_string_view())
+{}
+
+nlohmann::json InstallSnapshot::serialize_content() const
+{
+    nlohmann::json json_object;
+    json_object["leader_rank"] = this->_leader_rank;
+    json_object["last_included_index"] = this->_last_included_index;
+    json_object["last_included_term"] = this->_last_included_term;
+    json_object["offset"] = this->_offset;
+    json_object["done"] = this->_done;
+    json_object["crc"] = this->_crc;
+    json_object["data"] = this->_data;
+    return json_object;
+}
+
+void InstallSnapshot::serialize_content(BinaryWriter& writer) const
+{
+    writer.write_uint32(this->_leader_rank);
+    writer.write_int32(this->_last_included_index);
+    writer.write_int32(this->_last_included_term);
+    writer.write_uint32(this->_offset);
+    writer.write_bool(this->_done);
+    writer.write_uint32(this->_crc);
+    writer.write_string(this->_data);
+}
+
+// ========== InstallSnapshotResponse class implementation ==========
+
+InstallSnapshotResponse::InstallSnapshotResponse(int term, bool success, int last_included_index, size_t next_offset)
+    : RPC(term, RPC::RPC_TYPE::INSTALL_SNAPSHOT_RESPONSE), 
+      _success(success),
+      _last_included_index(last_included_index),
+      _next_offset(next_offset)
+{}
+
+InstallSnapshotResponse::InstallSnapshotResponse(int term, const nlohmann::json& serialized_json)
+    : RPC(term, RPC::RPC_TYPE::INSTALL_SNAPSHOT_RESPONSE), 
+      _success(serialized_json["success"]),
+      _last_included_index(serialized_json["last_included_index"]),
+      _next_offset(serialized_json["next_offset"])
+{}
+
+InstallSnapshotResponse::InstallSnapshotResponse(int term, const std::string& serialized) 
+    : InstallSnapshotResponse(term, nlohmann::json::parse(serialized))
+{}
+
+InstallSnapshotResponse::InstallSnapshotResponse(int term, BinaryReader& reader)
+    : RPC(term, RPC::RPC_TYPE::INSTALL_SNAPSHOT_RESPONSE), 
+      _success(reader.read_bool()),
+      _last_included_index(reader.read_int32()),
+      _next_offset(reader.read_uint32())
+{}
+
+nlohmann::json InstallSnapshotResponse::serialize_content() const
+{
+    nlohmann::json json_object;
+    json_object["success"] = this->_success;
+    json_object["last_included_index"] = this->_last_included_index;
+    json_object["next_offset"] = this->_next_offset;
+    return json_object;
+}
+
+void InstallSnapshotResponse::serialize_content(BinaryWriter& writer) const
+{
+    writer.write_bool(this->_success);
+    writer.write_int32(this->_last_included_index);
+    writer.write_uint32(this->_next_offset);
+}
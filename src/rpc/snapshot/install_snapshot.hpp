@@ -0,0 +1,56 @@
+#pragma once
+
+#include <cstdint>
+#include <string_view>
+
+#include "rpc/rpc.hpp"
+
+class InstallSnapshot : public RPC
+{
+public:
+    // The data is not copied, so it must be kept alive while the RPC is alive
+    InstallSnapshot(int term, size_t leader_rank, int last_included_index, int last_included_term, size_t offset, bool done, uint32_t crc, std::string_view data);
+    // The data is a view in the string of the JSON object, so the object must be kept alive while using the RPC
+    InstallSnapshot(int term, const nlohmann::json& serialized_json);
+    // The data is a view in the read data, so the data must be kept alive while using the RPC
+    InstallSnapshot(int term, BinaryReader& reader);
+
+    // Function used to serialize the class as a json to be sent later as a string
+    nlohmann::json serialize_content() const override;
+    // Function used to pack the class in the binary format
+    void serialize_content(BinaryWriter& writer) const override;
+
+    // Rank of the leader sending the snapshot
+    const size_t _leader_rank;
+    // Index and term of the last entry included in the snapshot (the snapshot replaces all the entries until this one)
+    const int _last_included_index;
+    const int _last_included_term;
+    // Offset of the chunk in the state of the snapshot, and true if this is the last chunk of the state
+    const size_t _offset;
+    const bool _done;
+    // CRC32 of the snapshot file of the leader (used to check the snapshot once all its chunks are received)
+    const uint32_t _crc;
+    // Chunk of the state of the state machine once all the entries of the snapshot are applied
+    const std::string_view _data;
+};
+
+class InstallSnapshotResponse : public RPC
+{
+public:
+    InstallSnapshotResponse(int term, bool success, int last_included_index, size_t next_offset);
+    InstallSnapshotResponse(int term, const nlohmann::json& serialized_json);
+    InstallSnapshotResponse(int term, const std::string& serialized);
+    InstallSnapshotResponse(int term, BinaryReader& reader);
+
+    // Function used to serialize the class as a json to be sent later as a string
+    nlohmann::json serialize_content() const override;
+    // Function used to pack the class in the binary format
+    void serialize_content(BinaryWriter& writer) const override;
+
+    // If this is True, the snapshot has been installed by the server
+    const bool _success;
+    // Index of the last entry included in the snapshot (if it is installed, the logs of the server match the leader logs until this one)
+    const int _last_included_index;
+    // If the snapshot is not installed yet, offset of the next chunk of the state to send (the size of the state already received)
+    const size_t _next_offset;
+};
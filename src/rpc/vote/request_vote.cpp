@@ -19,6 +19,13 @@ VoteRequest::VoteRequest(int server_term, const std::string& serialized)
     : VoteRequest(server_term, nlohmann::json::parse(serialized))
 {}
 
+VoteRequest::VoteRequest(int server_term, BinaryReader& reader)
+    : RPC(server_term, RPC::RPC_TYPE::VOTE_REQUEST), 
+      _candidate_rank(reader.read_uint32()), 
+      _last_log_index((size_t)reader.read_int32()), 
+      _last_log_term(reader.read_int32())
+{}
+
 nlohmann::json VoteRequest::serialize_content() const
 {
     nlohmann::json json_object;
@@ -28,6 +35,14 @@ nlohmann::json VoteRequest::serialize_content() const
     return json_object;
 }
 
+void VoteRequest::serialize_content(BinaryWriter& writer) const
+{
+    writer.write_uint32(this->_candidate_rank);
+    // The last log index is -1 (so the max of size_t) when the candidate has no logs
+    writer.write_int32((int)this->_last_log_index);
+    writer.write_int32(this->_last_log_term);
+}
+
 // ========== RequestVoteResponse class implementation ==========
 
 VoteResponse::VoteResponse(int term, bool vote)
@@ -42,9 +57,18 @@ VoteResponse::VoteResponse(int term, const std::string& serialized)
     : VoteResponse(term, nlohmann::json::parse(serialized))
 {}
 
+VoteResponse::VoteResponse(int term, BinaryReader& reader)
+    : VoteResponse(term, reader.read_bool())
+{}
+
 nlohmann::json VoteResponse::serialize_content() const
 {
     nlohmann::json json_object;
     json_object["vote"] = this->_vote;
     return json_object;
+}
+
+void VoteResponse::serialize_content(BinaryWriter& writer) const
+{
+    writer.write_bool(this->_vote);
 }
\ No newline at end of file
@@ -8,9 +8,12 @@ public:
     VoteRequest(int server_term, size_t candidate_rank, size_t last_log_index, int last_log_term);
     VoteRequest(int server_term, const nlohmann::json& serialized_json);
     VoteRequest(int server_term, const std::string& serialized);
+    VoteRequest(int server_term, BinaryReader& reader);
 
     // Function used to serialize the class as a json to be sent later as a string
     nlohmann::json serialize_content() const override;
+    // Function used to pack the class in the binary format
+    void serialize_content(BinaryWriter& writer) const override;
 
     // Rank of the candidate requesting vote
     const size_t _candidate_rank;
@@ -26,9 +29,12 @@ public:
     VoteResponse(int server_term, bool vote);
     VoteResponse(int server_term, const nlohmann::json& serialized_json);
     VoteResponse(int server_term, const std::string& serialized);
+    VoteResponse(int server_term, BinaryReader& reader);
 
     // Function used to serialize the class as a json to be sent later as a string
     nlohmann::json serialize_content() const override;
+    // Function used to pack the class in the binary format
+    void serialize_content(BinaryWriter& writer) const override;
 
     // If this is True, this means candidate gives the vote
     const bool _vote;
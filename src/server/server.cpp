@@ -2,45 +2,94 @@
 
 // Include the file where all the communication functions are
 #include "rpc/rpc_communication.hpp"
+#include "log/file_utils.hpp"
+#include "state_machine/key_value_state_machine.hpp"
+#include "state_machine/log_state_machine.hpp"
+#include "state_machine/session_state_machine.hpp"
 
 // ========== Constructor function ==========
 
-Server::Server(int rank, int servers_count, int clients_count) 
-    : _rank(rank), _status(ServerStatus::FOLLOWER), _current_term(0), _clock(Clock()), 
+Server::Server(int rank, int servers_count, int clients_count, const ServerConfig& config) 
+    : _rank(rank), _status(ServerStatus::FOLLOWER), _current_term(0), _applied_entries_count(0), _apply_duration(0), _config(config), _clock(Clock()), 
       _voted_for(0), _vote_count(0), _servers_count(servers_count), _clients_count(clients_count),  
-      _commit_index(-1), _last_log_applied(-1)
+      _write_ahead_log("server_logs/wal_server_" + std::to_string(rank), config.wal_sync_interval, config.segment_size), _flushed_log_index(-1),
+      _metadata_store("server_logs/metadata_server_" + std::to_string(rank)),
+      _snapshot_store("server_logs/snapshot_server_" + std::to_string(rank)),
+      _commit_index(-1), _last_log_applied(-1), _batch_pending(false),
+      _read_round(0), _confirmed_read_round(0), _leader_rank(0), _leader_commit_index(-1), _next_forward_id(1)
 {
     // Timeout initializations
     srand(time(NULL) + this->_rank);
-    this->_election_timeout = rand() % 200 + 200;   // timeout from 200 to 400
+    this->_min_election_timeout = 200;
+    this->_election_timeout = rand() % 200 + this->_min_election_timeout;   // timeout from 200 to 400
     this->_heartbeat_timeout = 25;
+    this->_retransmit_timeout = 4 * this->_heartbeat_timeout;
+    this->_commit_persist_timeout = 4 * this->_heartbeat_timeout;
 
     // Setting the stop variable to false
     this->_is_stopped = false;
     // Setting up the server speed
     this->_server_speed = ServerSpeed::HIGH;
 
-    // Creating the log path of the server
-    this->_log_filepath = "server_logs/logs_server_" + std::to_string(rank) + ".txt";
+    // Creating the state machine of the server (the applied entries are written in the log file of the server by default)
+    this->_state_filepath = "server_logs/state_server_" + std::to_string(rank);
+    std::unique_ptr<StateMachine> state_machine;
+    if (this->_config.kv_store)
+    {
+        state_machine = std::make_unique<KeyValueStateMachine>();
+    }
+    else
+    {
+        state_machine = std::make_unique<LogStateMachine>("server_logs/logs_server_" + std::to_string(rank) + ".txt");
+    }
+    // The entries of the clients are applied through their sessions, so an entry sent several times by a client is only applied once
+    this->_state_machine = std::make_unique<SessionStateMachine>(std::move(state_machine));
 
     // Initializing the vectors of the server for logs synchronization
     this->_next_log_index = std::vector(servers_count, 0);
     this->_log_index_match = std::vector(servers_count, -1);
+    this->_sent_log_index = std::vector(servers_count, 0);
+    this->_replication_clocks = std::vector(servers_count, Clock());
+    this->_snapshot_offsets = std::vector<size_t>(servers_count, 0);
+    this->_read_round_acks = std::vector(servers_count, 0);
 
-    // Initializing the log file of the server
-    std::ofstream logs_file;
-    logs_file.open(this->_log_filepath);
-    if (!logs_file.good())
+    // Restoring the logs of the server from its snapshot and its write-ahead log (if the server is restarting), or starting with empty logs
+    // The restored entries are applied again once the server knows that they are committed
+    if (this->_config.restore)
+    {
+        // The state of the snapshot is restored in the state machine directly, as all its entries are applied
+        if (this->_snapshot_store.load(this->_snapshot))
+        {
+            this->_server_log.reset(this->_snapshot._last_included_index, this->_snapshot._last_included_term);
+            this->install_state();
+            this->_commit_index = this->_snapshot._last_included_index;
+            this->_last_log_applied = this->_snapshot._last_included_index;
+        }
+        if (!this->_write_ahead_log.restore(this->_server_log))
+        {
+            std::cerr << "Server " << this->_rank << " could not restore all of its logs, the missing entries will be sent by the leader." << std::endl;
+        }
+        // Restoring the term, the vote and the commit index, so that the server does not start an election to catch up the term
+        this->load_metadata();
+    }
+    else
     {
-        std::cerr << "Unable to open server logs file !" << std::endl;
+        this->_write_ahead_log.clear();
+        this->_metadata_store.clear();
+        this->_snapshot_store.clear();
     }
-    logs_file.close();
+    this->_flushed_log_index = (int)this->_server_log.size() - 1;
 };
 
 // ========== Status changes function ==========
 
 void Server::set_as_follower()
 {
+    // The reads of a leader are denied, as its rounds do not mean anything for a follower (the reads of a follower are kept)
+    if (this->_status != ServerStatus::FOLLOWER)
+    {
+        this->deny_reads();
+    }
     this->_status = ServerStatus::FOLLOWER;
     this->_voted_for = 0;
     this->_vote_count = 0;
@@ -55,13 +104,19 @@ void Server::set_as_candidate()
     // Term is monotonically increasing, here we are electing the leader of this term  
     this->_current_term += 1;
 
+    // The leader of the new term is not known yet
+    this->_leader_rank = 0;
+
     // Voting for himself
     this->_voted_for = this->_rank;
     this->_vote_count = 1;
 
+    // The new term and the vote must be durable before requesting the votes (so that the server does not vote again for this term after a crash)
+    this->persist_metadata();
+
     // Getting the term of the last log of this server
     // Setting it to -1 if there is no logs to make it clear that this is the first one
-    const int last_log_term = this->_server_log.empty() ? -1 : this->_server_log.back()._term;
+    const int last_log_term = this->_server_log.last_term();
 
     // Request for vote
     VoteRequest request = VoteRequest(this->_current_term, this->_rank, this->_server_log.size() - 1, last_log_term);
@@ -75,6 +130,7 @@ void Server::set_as_leader()
 {
     this->_status = ServerStatus::LEADER;
     this->_clock.reset();
+    this->_batch_pending = false;
 
     // Setting up the new next log index for all the servers as this one is the new leader
     // Also setting up the match log index to -1 as we don't know if any of the log match the leader logs
@@ -83,7 +139,13 @@ void Server::set_as_leader()
     {
         this->_next_log_index.at(server_rank) = new_log_index;
         this->_log_index_match.at(server_rank) = -1;
+        this->_sent_log_index.at(server_rank) = new_log_index;
+        this->_snapshot_offsets.at(server_rank) = 0;
+        this->_read_round_acks.at(server_rank) = 0;
     }
+    // The rounds of heartbeats of the previous terms are not valid anymore
+    this->_read_round = 0;
+    this->_confirmed_read_round = 0;
 
     // Send a first heartbeat as the new leader 
     int offset = this->_clients_count + 1; 
@@ -95,7 +157,7 @@ void Server::set_as_leader()
         {
             // Getting the previous log index and log term for the Heartbeat Query
             int prev_log_index = this->_next_log_index.at(server_rank) - 1;
-            int prev_log_term = (prev_log_index >= 0) && (prev_log_index < (int)this->_server_log.size()) ? this->_server_log.at(prev_log_index)._term : -1;
+            int prev_log_term = this->_server_log.term_at(prev_log_index);
 
             Heartbeat start_heartbeat = Heartbeat(this->_current_term, this->_rank, prev_log_index, prev_log_term, this->_commit_index);
             send_message(start_heartbeat, destination_rank, 0);
@@ -116,7 +178,7 @@ void Server::candidate_routine(const std::vector<Query>& queries)
             this->_vote_count += vote_response._vote ? 1 : 0;
         }
         // If the candidate receive an entry from the leader, set as follower
-        if (query._type == RPC::RPC_TYPE::APPEND_ENTRIES || query._type == RPC::RPC_TYPE::HEARTBEAT)
+        if (query._type == RPC::RPC_TYPE::APPEND_ENTRIES || query._type == RPC::RPC_TYPE::HEARTBEAT || query._type == RPC::RPC_TYPE::INSTALL_SNAPSHOT)
         {
             // While handling the Append Entries query, if the term is superior to the server term, set it as follower
             if (query._term >= this->_current_term)
@@ -143,38 +205,10 @@ void Server::leader_routine(const std::vector<Query>& queries)
     // As for MPI, we initialize the controler and then the clients, the offset for the servers is the number of clients
     // We are setting up this value here as we will use it for the heartbeat timeout and the queries parsing
     int offset = this->_clients_count + 1; 
-    if (this->_clock.check() > this->_heartbeat_timeout)
+    // With the pipelined replication, the entries are sent after parsing the queries (see replicate_pipelined)
+    if (this->_config.pipeline_window == 0 && this->_clock.check() > this->_heartbeat_timeout)
     {
-        for (int server_rank = 0; server_rank < this->_servers_count; server_rank++)
-        {
-            // Only used to send the request (as we have a offset with the clients)
-            int destination_rank = offset + server_rank;
-            if (destination_rank != this->_rank)
-            {
-                // Getting the previous log index and log term for the Append Entries Query
-                int prev_log_index = this->_next_log_index.at(server_rank) - 1;
-                int prev_log_term = (prev_log_index >= 0) && (prev_log_index < (int)this->_server_log.size()) ? this->_server_log.at(prev_log_index)._term : -1;
-                
-                // Check if the size of the logs of the server is superior or equal to the index of the next logs to send to the destination server
-                // If it is not the case, then we don't have any logs to send so we don't need to do anything
-                if ((int)this->_server_log.size() - 1 >= this->_next_log_index.at(server_rank))
-                {
-                    // Getting all the logs that we need to send 
-                    auto start = this->_server_log.begin() + this->_next_log_index.at(server_rank);
-                    auto end = this->_server_log.end();
-                    std::vector<LogEntry> entries_to_send(start, end);
-
-                    AppendEntries append_entry = AppendEntries(this->_current_term, this->_rank, prev_log_index, prev_log_term, entries_to_send, this->_commit_index);
-                    send_message(append_entry, destination_rank, 0);
-                }
-                else
-                {
-                    // Sending a Heartbeat to the destination_rank server 
-                    Heartbeat heartbeat = Heartbeat(this->_current_term, this->_rank, prev_log_index, prev_log_term, this->_commit_index);
-                    send_message(heartbeat, destination_rank, 0);
-                }
-            }
-        }
+        this->replicate_to_followers(true);
 
         // Reset the clock as we send a query
         this->_clock.reset();
@@ -186,57 +220,581 @@ void Server::leader_routine(const std::vector<Query>& queries)
         if (query._type == RPC::RPC_TYPE::NEW_LOG_ENTRY)
         {
             const NewLogEntry& new_entry = std::get<NewLogEntry>(query._content);
-            this->_server_log.emplace_back(this->_current_term, new_entry._log_entry._command);
-            this->_entries_queue.emplace(query);
+            if (new_entry._log_entries.empty())
+            {
+                send_message(NewLogEntryResponse(new_entry._request_id, true), query._source_rank, 0);
+                continue;
+            }
+            // A batch sent again by its client (or forwarded by a follower) is not appended a second time
+            if (this->handle_duplicate_entries(query, new_entry))
+            {
+                continue;
+            }
+            // The commands are views in the receive buffer of the query so they are copied only here, when the batch is added to the arena of the logs
+            const int first_log_index = this->_server_log.size();
+            this->_server_log.append(this->_current_term, new_entry._log_entries);
+            for (int index = first_log_index; index < (int)this->_server_log.size(); index++)
+            {
+                this->_write_ahead_log.append(index, this->_server_log.at(index));
+            }
+            ClientEntry client_entry = ClientEntry{first_log_index, (int)this->_server_log.size() - 1, this->_current_term, query._source_rank, new_entry._request_id, {}};
+            client_entry._results.reserve(new_entry._log_entries.size());
+            this->_entries_queue.emplace(first_log_index, std::move(client_entry));
+
+            // Starting a new batch with this entry if there is not already one
+            if (!this->_batch_pending)
+            {
+                this->_batch_pending = true;
+                this->_batch_clock.reset();
+            }
         }
-        else if (query._type == RPC::RPC_TYPE::APPEND_ENTRIES_RESPONSE)
+        // The responses to the requests of the previous terms are ignored as the logs of the follower may have changed since
+        else if (query._type == RPC::RPC_TYPE::APPEND_ENTRIES_RESPONSE && query._term == this->_current_term)
         {
             const AppendEntriesResponse& response = std::get<AppendEntriesResponse>(query._content);
             size_t source_rank = query._source_rank - offset;
 
-            // If the response is success, then update the match and next log indexes
-            if (response._success)
+            this->handle_append_entries_response(source_rank, response);
+        }
+        else if (query._type == RPC::RPC_TYPE::INSTALL_SNAPSHOT_RESPONSE && query._term == this->_current_term)
+        {
+            const InstallSnapshotResponse& response = std::get<InstallSnapshotResponse>(query._content);
+            size_t source_rank = query._source_rank - offset;
+
+            this->handle_install_snapshot_response(source_rank, response);
+        }
+        // The query of the read is a view in the receive buffer, so it is copied until the read is answered
+        else if (query._type == RPC::RPC_TYPE::READ_REQUEST)
+        {
+            const ReadRequest& read_request = std::get<ReadRequest>(query._content);
+            this->_pending_reads.push_back(PendingRead{query._source_rank, read_request._request_id, std::string(read_request._query), UNKNOWN_READ_INDEX, 0, 0});
+        }
+        // The read index requests of the followers are confirmed by the rounds as the reads of the clients
+        else if (query._type == RPC::RPC_TYPE::READ_INDEX_REQUEST)
+        {
+            const ReadIndexRequest& request = std::get<ReadIndexRequest>(query._content);
+            this->_pending_reads.push_back(PendingRead{query._source_rank, 0, std::string(), UNKNOWN_READ_INDEX, 0, request._read_round});
+        }
+        else if (query._type == RPC::RPC_TYPE::HEARTBEAT_RESPONSE && query._term == this->_current_term)
+        {
+            const HeartbeatResponse& response = std::get<HeartbeatResponse>(query._content);
+            size_t source_rank = query._source_rank - offset;
+
+            this->handle_heartbeat_response(source_rank, response);
+        }
+    }
+    
+    // Writing the new entries in the write-ahead log (all the entries received in this update are written at once)
+    this->flush_write_ahead_log();
+
+    // Sending the new entries to the followers once the batch window is over (without waiting for the heartbeat)
+    // With the pipelined replication, the entries are also sent to the followers that are catching up when there is no batch
+    const bool batch_ready = this->_batch_pending && this->_batch_clock.check_microseconds() >= this->_config.batch_window;
+    if (this->_config.pipeline_window > 0)
+    {
+        this->replicate_pipelined(batch_ready || !this->_batch_pending);
+    }
+    else if (this->_config.eager_replication && batch_ready)
+    {
+        this->replicate_to_followers(false);
+    }
+    if (batch_ready)
+    {
+        this->_batch_pending = false;
+    }
+    
+    // Updating the commit index of the leader (also done on every acknowledgement, this is for the new entries of the leader)
+    // And applying directly the committed entries to answer the clients without waiting for the next update
+    this->advance_commit_index();
+    this->apply_committed_entries();
+
+    // Answering the reads whose round is confirmed and whose entries are applied
+    this->handle_reads();
+}
+
+// ========== Replication functions ==========
+
+// Function used to send to each follower all the entries that it did not acknowledged yet
+// If a follower has no entries to receive, it is sent a Heartbeat instead if send_heartbeats is true
+void Server::replicate_to_followers(bool send_heartbeats)
+{
+    const int offset = this->_clients_count + 1; 
+    for (int server_rank = 0; server_rank < this->_servers_count; server_rank++)
+    {
+        // Only used to send the request (as we have a offset with the clients)
+        int destination_rank = offset + server_rank;
+        if (destination_rank != this->_rank)
+        {
+            // Getting the previous log index and log term for the Append Entries Query
+            int prev_log_index = this->_next_log_index.at(server_rank) - 1;
+            int prev_log_term = this->_server_log.term_at(prev_log_index);
+            
+            // If the entries to send were removed by a snapshot, the snapshot is sent instead (and sent again if it is not acknowledged in time)
+            if (this->_next_log_index.at(server_rank) < (int)this->_server_log.first_index() && (this->_sent_log_index.at(server_rank) <= this->_next_log_index.at(server_rank)
+                || this->_replication_clocks.at(server_rank).check() > this->_retransmit_timeout))
             {
-                this->_log_index_match.at(source_rank) += 1;
+                this->send_snapshot(server_rank);
+            }
+            // Check if the size of the logs of the server is superior or equal to the index of the next logs to send to the destination server
+            // If it is not the case, then we don't have any logs to send so we don't need to do anything
+            else if (this->_next_log_index.at(server_rank) >= (int)this->_server_log.first_index() 
+                     && (int)this->_server_log.size() - 1 >= this->_next_log_index.at(server_rank))
+            {
+                // Getting all the logs that we need to send (they are already encoded, so they are only copied in the message)
+                const size_t entries_count = this->_server_log.size() - this->_next_log_index.at(server_rank);
+                std::string_view entries_to_send = this->_server_log.encoded_entries(this->_next_log_index.at(server_rank));
 
-                if (this->_log_index_match.at(source_rank) >= this->_next_log_index.at(source_rank))
-                {
-                    this->_next_log_index.at(source_rank) += 1;
-                }
+                AppendEntries append_entry = AppendEntries(this->_current_term, this->_rank, prev_log_index, prev_log_term, entries_to_send, entries_count, this->_commit_index);
+                send_message(append_entry, destination_rank, 0);
             }
-            // If not, then decrease the source rank next log index
-            else
+            else if (send_heartbeats)
             {
-                this->_next_log_index.at(source_rank) -= 1;
+                // Sending a Heartbeat to the destination_rank server 
+                Heartbeat heartbeat = Heartbeat(this->_current_term, this->_rank, prev_log_index, prev_log_term, this->_commit_index);
+                send_message(heartbeat, destination_rank, 0);
             }
         }
     }
-    
-    // Updating the commit index of the leader 
-    int new_commit_index = this->_commit_index + 1;
-    size_t updated_commit_count = 1; // Set at 1 because there is the leader
+}
+
+// With the pipelined replication, the leader keeps for each follower a window of entries that are sent and not acknowledged yet
+// This window goes from the next log index (first entry not acknowledged) to the sent log index (first entry not sent yet)
+// The leader only sends the entries that are not in the window yet, and only sends the window again on a reject or a timeout
+void Server::replicate_pipelined(bool send_entries)
+{
+    const bool heartbeat_timeout = this->_clock.check() > this->_heartbeat_timeout;
+    const int offset = this->_clients_count + 1;
+    const int last_log_index = (int)this->_server_log.size() - 1;
+
+    for (int server_rank = 0; server_rank < this->_servers_count; server_rank++)
+    {
+        // Only used to send the request (as we have a offset with the clients)
+        int destination_rank = offset + server_rank;
+        if (destination_rank == this->_rank)
+        {
+            continue;
+        }
+
+        int& next_log_index = this->_next_log_index.at(server_rank);
+        int& sent_log_index = this->_sent_log_index.at(server_rank);
+        Clock& replication_clock = this->_replication_clocks.at(server_rank);
+
+        // If the entries of the window have not been acknowledged in time, send them again
+        if (sent_log_index > next_log_index && replication_clock.check() > this->_retransmit_timeout)
+        {
+            sent_log_index = next_log_index;
+        }
+
+        // If the entries to send were removed by a snapshot, the snapshot is sent instead of the window
+        const bool needs_snapshot = next_log_index < (int)this->_server_log.first_index();
+        if (needs_snapshot && sent_log_index <= next_log_index)
+        {
+            this->send_snapshot(server_rank);
+        }
+        // Sending the entries that are not sent yet, as long as the window is not full
+        const int window_end = std::min(last_log_index, next_log_index + this->_config.pipeline_window - 1);
+        if (needs_snapshot)
+        {
+            // Nothing else to send until the snapshot is acknowledged, except the heartbeats
+            if (heartbeat_timeout)
+            {
+                Heartbeat heartbeat = Heartbeat(this->_current_term, this->_rank, next_log_index - 1, -1, this->_commit_index);
+                send_message(heartbeat, destination_rank, 0);
+            }
+        }
+        else if (send_entries && sent_log_index <= window_end)
+        {
+            // The timeout of the window starts when the first entry of the window is sent
+            if (sent_log_index == next_log_index)
+            {
+                replication_clock.reset();
+            }
+
+            int prev_log_index = sent_log_index - 1;
+            int prev_log_term = this->_server_log.term_at(prev_log_index);
+
+            const size_t entries_count = window_end - sent_log_index + 1;
+            std::string_view entries_to_send = this->_server_log.encoded_entries(sent_log_index, window_end + 1);
+            AppendEntries append_entry = AppendEntries(this->_current_term, this->_rank, prev_log_index, prev_log_term, entries_to_send, entries_count, this->_commit_index);
+            send_message(append_entry, destination_rank, 0);
+
+            sent_log_index = window_end + 1;
+        }
+        // The heartbeats are still sent to make sure that the followers don't start an election
+        else if (heartbeat_timeout)
+        {
+            int prev_log_index = next_log_index - 1;
+            int prev_log_term = this->_server_log.term_at(prev_log_index);
+
+            Heartbeat heartbeat = Heartbeat(this->_current_term, this->_rank, prev_log_index, prev_log_term, this->_commit_index);
+            send_message(heartbeat, destination_rank, 0);
+        }
+    }
+
+    if (heartbeat_timeout)
+    {
+        this->_clock.reset();
+    }
+}
+
+// Function used to send the last snapshot to a follower whose next entries were removed from the logs
+// The state of the snapshot is sent by chunks read from the snapshot file, a single chunk being sent at a time to each follower
+// The next chunk is sent once the follower acknowledges the previous one, so the transfer does not delay the other messages to the follower
+// The snapshot is considered as sent until the sent log index, and the chunk is sent again if it is not acknowledged after the retransmit timeout
+void Server::send_snapshot(size_t server_rank)
+{
+    const int destination_rank = this->_clients_count + 1 + server_rank;
+    const size_t offset = std::min(this->_snapshot_offsets.at(server_rank), this->_snapshot._state_size);
+    const size_t chunk_size = std::min((size_t)this->_config.snapshot_chunk_size, this->_snapshot._state_size - offset);
+    const std::string chunk = this->_snapshot_store.read_chunk(offset, chunk_size);
+    const bool done = offset + chunk.size() == this->_snapshot._state_size;
+
+    InstallSnapshot install_snapshot = InstallSnapshot(this->_current_term, this->_rank, this->_snapshot._last_included_index, 
+                                                       this->_snapshot._last_included_term, offset, done, this->_snapshot._crc, chunk);
+    send_message(install_snapshot, destination_rank, 0);
+
+    this->_sent_log_index.at(server_rank) = this->_snapshot._last_included_index + 1;
+    this->_replication_clocks.at(server_rank).reset();
+}
+
+void Server::handle_install_snapshot_response(size_t server_rank, const InstallSnapshotResponse& response)
+{
+    // The follower is waiting for the chunk following the state it has already received (it may have received it from a previous leader)
+    // The responses for a previous snapshot are ignored, the new snapshot is sent with the next retransmission
+    if (!response._success)
+    {
+        if (response._last_included_index == this->_snapshot._last_included_index 
+            && this->_next_log_index.at(server_rank) < (int)this->_server_log.first_index())
+        {
+            this->_snapshot_offsets.at(server_rank) = response._next_offset;
+            this->send_snapshot(server_rank);
+        }
+        return;
+    }
+    this->_snapshot_offsets.at(server_rank) = 0;
+    // The logs of the follower match the leader logs until the last entry of the snapshot
+    if (response._last_included_index > this->_log_index_match.at(server_rank))
+    {
+        this->_log_index_match.at(server_rank) = response._last_included_index;
+    }
+    if (response._last_included_index + 1 > this->_next_log_index.at(server_rank))
+    {
+        this->_next_log_index.at(server_rank) = response._last_included_index + 1;
+        this->_sent_log_index.at(server_rank) = std::max(this->_sent_log_index.at(server_rank), this->_next_log_index.at(server_rank));
+        this->_replication_clocks.at(server_rank).reset();
+    }
+    this->advance_commit_index();
+}
 
-    // Checking if the commit index is the same for the server and counting them
-    for (size_t server_rank = 0; server_rank < this->_servers_count; server_rank++)
+void Server::advance_commit_index()
+{
+    // Getting the index of the last entry replicated on each server (the leader has all of its entries)
+    const int offset = this->_clients_count + 1;
+    std::vector<int> match_indexes = this->_log_index_match;
+    match_indexes.at(this->_rank - offset) = std::min(this->_flushed_log_index, (int)this->_server_log.size() - 1);
+
+    // The highest index replicated on the majority of the servers is the (servers_count / 2 + 1)th greatest match index
+    auto majority = match_indexes.begin() + this->_servers_count / 2;
+    std::nth_element(match_indexes.begin(), majority, match_indexes.end(), std::greater<int>());
+    const int majority_index = *majority;
+
+    // Only the entries of the current term are committed by counting the replicas (the previous ones are committed with them)
+    // As the terms of the logs are increasing, if the entry at majority_index is not of the current term, none of the previous one are
+    if (majority_index > this->_commit_index && this->_server_log.at(majority_index)._term == this->_current_term)
     {
-        if (this->_rank != (server_rank + offset))
+        this->_commit_index = majority_index;
+    }
+}
+
+void Server::handle_append_entries_response(size_t server_rank, const AppendEntriesResponse& response)
+{
+    int& next_log_index = this->_next_log_index.at(server_rank);
+    int& sent_log_index = this->_sent_log_index.at(server_rank);
+
+    if (response._success)
+    {
+        // The responses may come from entries sent again, so the indexes are only increased
+        if (response._match_index > this->_log_index_match.at(server_rank))
+        {
+            this->_log_index_match.at(server_rank) = response._match_index;
+        }
+        if (response._match_index + 1 > next_log_index)
+        {
+            next_log_index = response._match_index + 1;
+            sent_log_index = std::max(sent_log_index, next_log_index);
+            // Some entries of the window are acknowledged, so the timeout of the window starts again
+            this->_replication_clocks.at(server_rank).reset();
+        }
+
+        // Some new entries may be replicated on the majority of the servers
+        this->advance_commit_index();
+    }
+    // If the follower rejected the entries, use the hints of the response to find the next log index to send
+    else if (response._conflict_index >= 0)
+    {
+        int new_next_log_index = response._conflict_index;
+        // If the leader has entries of the conflicting term, the follower logs match until the last of them
+        if (response._conflict_term != -1)
         {
-            if (this->_log_index_match.at(server_rank) >= new_commit_index)
+            const int last_index = this->_server_log.last_index_until_term(response._conflict_term);
+            if (last_index >= 0 && this->_server_log.term_at(last_index) == response._conflict_term)
             {
-                updated_commit_count += 1;
+                new_next_log_index = last_index + 1;
             }
         }
+        // The entries already known to be replicated are not sent again
+        new_next_log_index = std::max(new_next_log_index, this->_log_index_match.at(server_rank) + 1);
+
+        // The rejects of the entries sent after the rejected ones are ignored as they are not going back further
+        if (new_next_log_index < next_log_index)
+        {
+            next_log_index = new_next_log_index;
+            sent_log_index = next_log_index;
+        }
     }
+}
 
-    // Then if the majority (so more than the half of the servers) are up to date with th commit index, 
-    // Update the leader's commit index
-    if ((updated_commit_count > (this->_servers_count / 2)))
+// ========== Read functions ==========
+
+// The reads are answered without adding them to the logs (ReadIndex) :
+//  - the leader must have committed an entry of its term, to know all the committed entries (a no-op entry is added otherwise)
+//  - the commit index is kept as the read index of the reads, and a round of heartbeats is sent to the followers
+//  - once the majority of the servers answered the round, no other leader was elected when the round started
+//  - the reads are then answered from the state machine once their read index is applied
+// All the reads received during a round are answered by the next round, so a single round is in progress at a time
+//
+// With the lease reads, the leader also starts a round on each heartbeat timeout to keep a lease
+// The followers answering a round do not vote for another server during the minimum election timeout (see handle_queries)
+// So no other leader can be elected until the minimum election timeout since the start of the round, minus the drift of the clocks
+// While the lease is valid, the reads are confirmed by the last confirmed round, without waiting for a new one
+void Server::handle_reads()
+{
+    // Adding an entry without command if the leader did not commit an entry of its term yet (it is sent to the followers with the next batch)
+    const bool term_committed = this->_server_log.term_at(this->_commit_index) == this->_current_term;
+    if (!this->_pending_reads.empty() && !term_committed && this->_server_log.last_term() != this->_current_term)
+    {
+        this->_server_log.append(this->_current_term, std::string_view());
+        this->_write_ahead_log.append(this->_server_log.size() - 1, this->_server_log.back());
+        if (!this->_batch_pending)
+        {
+            this->_batch_pending = true;
+            this->_batch_clock.reset();
+        }
+    }
+
+    // Confirming the reads with the lease of the leader
+    const bool lease_valid = this->_config.lease_read && this->_confirmed_read_round > 0 
+                             && this->_lease_clock.check() < this->_min_election_timeout - this->_config.lease_drift;
+    if (lease_valid && term_committed)
+    {
+        for (PendingRead& read : this->_pending_reads)
+        {
+            if (read._read_round == 0)
+            {
+                read._read_index = this->_commit_index;
+                read._read_round = this->_confirmed_read_round;
+            }
+            else if (read._read_round > this->_confirmed_read_round)
+            {
+                read._read_round = this->_confirmed_read_round;
+            }
+        }
+    }
+
+    // Starting a new round for the reads received since the last one, or to renew the lease
+    // If the round is not confirmed in time, a new round is started for its reads (the lease starts with the round that is confirmed)
+    const bool round_in_progress = this->_read_round > this->_confirmed_read_round;
+    const bool new_reads = term_committed && !this->_pending_reads.empty() && this->_pending_reads.back()._read_round == 0;
+    const bool renew_lease = this->_config.lease_read && this->_read_round_clock.check() > this->_heartbeat_timeout;
+    if ((!round_in_progress && (new_reads || renew_lease)) || (round_in_progress && this->_read_round_clock.check() > this->_retransmit_timeout))
+    {
+        this->start_read_round();
+    }
+
+    // Answering the reads in order, until the first one that is not confirmed or not applied yet
+    // The followers are sent the read index of their requests, they answer their reads once they applied it
+    while (!this->_pending_reads.empty() && this->_pending_reads.front()._read_round != 0
+           && this->_pending_reads.front()._read_round <= this->_confirmed_read_round
+           && this->_pending_reads.front()._read_index <= this->_last_log_applied)
+    {
+        const PendingRead& read = this->_pending_reads.front();
+        if (read._follower_read_round != 0)
+        {
+            send_message(ReadIndexResponse(this->_current_term, read._follower_read_round, read._read_index), read._source_rank, 0);
+        }
+        else
+        {
+            send_message(ReadResponse(read._request_id, true, this->_state_machine->read(read._query)), read._source_rank, 0);
+        }
+        this->_pending_reads.pop_front();
+    }
+}
+
+void Server::start_read_round()
+{
+    this->_read_round += 1;
+    this->_read_round_clock.reset();
+
+    // The reads of the rounds that are not confirmed are moved to the new round, and the new reads are added to it
+    // (the new reads are only added once the leader committed an entry of its term)
+    const bool term_committed = this->_server_log.term_at(this->_commit_index) == this->_current_term;
+    for (PendingRead& read : this->_pending_reads)
+    {
+        if (read._read_round == 0 && term_committed)
+        {
+            read._read_index = this->_commit_index;
+            read._read_round = this->_read_round;
+        }
+        else if (read._read_round > this->_confirmed_read_round)
+        {
+            read._read_round = this->_read_round;
+        }
+    }
+
+    const int offset = this->_clients_count + 1;
+    for (int server_rank = 0; server_rank < this->_servers_count; server_rank++)
+    {
+        int destination_rank = offset + server_rank;
+        if (destination_rank != this->_rank)
+        {
+            int prev_log_index = this->_next_log_index.at(server_rank) - 1;
+            int prev_log_term = this->_server_log.term_at(prev_log_index);
+
+            Heartbeat heartbeat = Heartbeat(this->_current_term, this->_rank, prev_log_index, prev_log_term, this->_commit_index, this->_read_round);
+            send_message(heartbeat, destination_rank, 0);
+        }
+    }
+
+    // The leader alone is the majority if there is a single server
+    this->handle_heartbeat_response(this->_rank - offset, HeartbeatResponse(this->_current_term, this->_read_round));
+}
+
+// The followers answer the reads with the read index of the leader (so the reads are not all answered by the leader) :
+//  - the follower sends a read index request to the leader for the reads received since the last request
+//  - the leader answers it with the read index of a confirmed round, as for its own reads
+//  - the follower answers the reads of the request once it applied the read index
+// If the request is not answered in time, a new request is sent for its reads (they are denied if the leader is not known)
+// The stale reads are answered without request, with the last commit index of the leader that the follower has committed
+void Server::handle_follower_reads()
+{
+    if (this->_pending_reads.empty())
+    {
+        return;
+    }
+
+    const bool request_in_progress = this->_read_round > this->_confirmed_read_round;
+    const bool new_reads = this->_pending_reads.back()._read_round == 0 && this->_pending_reads.back()._read_index == UNKNOWN_READ_INDEX;
+    if ((!request_in_progress && new_reads) || (request_in_progress && this->_read_round_clock.check() > this->_retransmit_timeout))
+    {
+        this->_read_round += 1;
+        this->_read_round_clock.reset();
+        for (auto read = this->_pending_reads.begin(); read != this->_pending_reads.end();)
+        {
+            if (read->_read_index != UNKNOWN_READ_INDEX)
+            {
+                read++;
+            }
+            else if (this->_leader_rank == 0)
+            {
+                send_message(ReadResponse(read->_request_id, false), read->_source_rank, 0);
+                read = this->_pending_reads.erase(read);
+            }
+            else
+            {
+                read->_read_round = this->_read_round;
+                read++;
+            }
+        }
+        if (this->_leader_rank != 0)
+        {
+            send_message(ReadIndexRequest(this->_current_term, this->_read_round), this->_leader_rank, 0);
+        }
+        else
+        {
+            this->_confirmed_read_round = this->_read_round;
+        }
+    }
+
+    // Answering the reads whose read index is applied (the reads of different requests can be answered in any order)
+    for (auto read = this->_pending_reads.begin(); read != this->_pending_reads.end();)
+    {
+        if (read->_read_index <= this->_last_log_applied)
+        {
+            send_message(ReadResponse(read->_request_id, true, this->_state_machine->read(read->_query)), read->_source_rank, 0);
+            read = this->_pending_reads.erase(read);
+        }
+        else
+        {
+            read++;
+        }
+    }
+}
+
+void Server::handle_read_index_response(const ReadIndexResponse& response)
+{
+    // The read index is -1 if the server receiving the request was not the leader, the reads are then denied
+    // The read index of a previous leader is still valid, as it was confirmed after the reads were received
+    this->_confirmed_read_round = std::max(this->_confirmed_read_round, response._read_round);
+    for (auto read = this->_pending_reads.begin(); read != this->_pending_reads.end();)
+    {
+        if (read->_read_round != response._read_round || read->_read_index != UNKNOWN_READ_INDEX)
+        {
+            read++;
+        }
+        else if (response._read_index == -1)
+        {
+            send_message(ReadResponse(read->_request_id, false, std::string(), this->_leader_rank), read->_source_rank, 0);
+            read = this->_pending_reads.erase(read);
+        }
+        else
+        {
+            read->_read_index = response._read_index;
+            read++;
+        }
+    }
+}
+
+void Server::deny_reads()
+{
+    // The reads of the clients are denied so that they send them to another server, the requests of the followers are sent again by them
+    for (const PendingRead& read : this->_pending_reads)
     {
-        if (this->_server_log.at(new_commit_index)._term == this->_current_term)
+        if (read._follower_read_round == 0)
         {
-            this->_commit_index = new_commit_index;
+            send_message(ReadResponse(read._request_id, false, std::string(), this->_leader_rank), read._source_rank, 0);
         }
     }
+    this->_pending_reads.clear();
+    this->_read_round = 0;
+    this->_confirmed_read_round = 0;
+}
+
+void Server::update_leader(size_t leader_rank, int leader_commit)
+{
+    this->_leader_rank = leader_rank;
+    // The state of the follower is as recent as the one of the leader when it sent its commit index, once the follower committed it
+    if (this->_commit_index >= leader_commit)
+    {
+        this->_leader_commit_index = leader_commit;
+        this->_leader_commit_clock.reset();
+    }
+}
+
+void Server::handle_heartbeat_response(size_t server_rank, const HeartbeatResponse& response)
+{
+    if (response._read_round > this->_read_round_acks.at(server_rank))
+    {
+        this->_read_round_acks.at(server_rank) = response._read_round;
+    }
+
+    // The round is confirmed once the majority of the servers (the leader included) answered it
+    const size_t acks_count = std::count_if(this->_read_round_acks.begin(), this->_read_round_acks.end(), 
+                                            [this](int read_round) { return read_round >= this->_read_round; });
+    if (this->_read_round > this->_confirmed_read_round && acks_count > this->_servers_count / 2)
+    {
+        this->_confirmed_read_round = this->_read_round;
+        this->_lease_clock = this->_read_round_clock;
+    }
 }
 
 // ========== Queries handling functions ==========
@@ -256,30 +814,23 @@ void Server::handle_vote_request(const Query& query)
         // If the logs of the candidate are empty and the logs of the server are empty
         if ((vote_request._last_log_index == -1) && (this->_server_log.empty()))
         {
-            send_message(VoteResponse(vote_request._term, true), vote_request._candidate_rank, 0);
+            // The vote is sent once it is written in the metadata
+            this->_pending_votes.emplace_back(vote_request._candidate_rank, VoteResponse(vote_request._term, true));
             this->_voted_for = vote_request._candidate_rank;
             // std::cerr << "Server " << this->_rank << " voted for " << vote_request._candidate_rank << std::endl;
             return;
         }
-        // If the candidate last log and the server last log terms are the same 
-        // Then check if the server logs are as updated as the server logs 
-        if (this->_server_log.at(vote_request._last_log_index)._term == vote_request._last_log_term)
-        {
-            if (vote_request._last_log_index >= this->_server_log.size())
-            {
-                send_message(VoteResponse(vote_request._term, true), vote_request._candidate_rank, 0);
-                this->_voted_for = vote_request._candidate_rank;
-                return;
-            }
-            else
-            {
-                send_message(VoteResponse(vote_request._term, false), vote_request._candidate_rank, 0);
-            }
-        }
-        // If the request last log term is greater than the server last log term then vote for the candidate
-        else if (this->_server_log.at(vote_request._last_log_index)._term < vote_request._last_log_term)
+        // Comparing the last log of the candidate with the last log of the server (the candidate logs may be longer than the server logs)
+        // The candidate logs are up to date if its last log term is greater, or if it is the same and its logs are at least as long
+        const int last_log_index = (int)this->_server_log.size() - 1;
+        const int last_log_term = this->_server_log.last_term();
+        const int candidate_last_log_index = (int)vote_request._last_log_index;
+
+        if ((vote_request._last_log_term > last_log_term) || 
+            (vote_request._last_log_term == last_log_term && candidate_last_log_index >= last_log_index))
         {
-            send_message(VoteResponse(vote_request._term, true), vote_request._candidate_rank, 0);
+            // The vote is sent once it is written in the metadata
+            this->_pending_votes.emplace_back(vote_request._candidate_rank, VoteResponse(vote_request._term, true));
             this->_voted_for = vote_request._candidate_rank;
             return;
         }
@@ -303,23 +854,40 @@ void Server::handle_new_entries(const Query& query)
     // If the query term is inferior to the server term, then deny query
     if (new_entries._term < this->_current_term)
     {
-        send_message(AppendEntriesResponse(this->_current_term, false), new_entries._leader_rank, 0);
+        send_message(AppendEntriesResponse(this->_current_term, false, -1), new_entries._leader_rank, 0);
         return;
     }
     // Check if there is entries to append to the logs
     // Normaly, should not happend as we have a dedicated class for the Heartbeat (but checked for safety)
     else if (!new_entries._entries.empty())
     {
+        // If the previous entry was removed by a snapshot of the server, the logs match the leader logs until the end of the snapshot
+        // (the entries of the snapshot are committed), so the leader can send the entries following the snapshot
+        if (new_entries._prev_log_index < (int)this->_server_log.first_index() - 1)
+        {
+            this->_clock.reset();
+            send_message(AppendEntriesResponse(new_entries._term, true, this->_server_log.first_index() - 1), new_entries._leader_rank, 0);
+            return;
+        }
         // Check if there is a previous log index
         if (new_entries._prev_log_index != -1)
         {
             // Check if the server logs contains a LogEntry at the previous log index of the query
             // Then check if the LogEntry contained at the previous index log of the query has the same term as the server
             // If those conditions are not met, then deny the request
-            if ((new_entries._prev_log_index >= (int)this->_server_log.size()) || 
-                (this->_server_log.at(new_entries._prev_log_index)._term != new_entries._prev_log_term))
+            // The response contains the hints for the leader to find directly the last matching entry
+            if (new_entries._prev_log_index >= (int)this->_server_log.size())
+            {
+                // The server logs are too short, so the leader can start from the end of the logs
+                send_message(AppendEntriesResponse(new_entries._term, false, -1, -1, this->_server_log.size()), new_entries._leader_rank, 0);
+                return;
+            }
+            if (this->_server_log.term_at(new_entries._prev_log_index) != new_entries._prev_log_term)
             {
-                send_message(AppendEntriesResponse(new_entries._term, false), new_entries._leader_rank, 0);
+                // All the entries of the conflicting term are skipped by the leader if it does not have this term
+                const int conflict_term = this->_server_log.term_at(new_entries._prev_log_index);
+                const int conflict_index = this->_server_log.last_index_until_term(conflict_term - 1) + 1;
+                send_message(AppendEntriesResponse(new_entries._term, false, -1, conflict_term, conflict_index), new_entries._leader_rank, 0);
                 return;
             }
         }
@@ -327,55 +895,102 @@ void Server::handle_new_entries(const Query& query)
         // Reseting the clock as we don't have any reasons to deny the query now
         this->_clock.reset();
 
-        // Starting and ending iterators to copy the logs that will not change
+        // Skipping the new entries that are already in the logs (same index and term), up to the first conflicting or missing entry
+        // The logs are then changed in place from this entry, so the cost only depends on the number of new entries
         const int previousLogIndex = new_entries._prev_log_index;
-        auto start = this->_server_log.begin();
-        auto end = this->_server_log.begin() + previousLogIndex + 1;
-        std::vector<LogEntry> new_logs(start, end);
+        const int new_entries_end = previousLogIndex + 1 + (int)new_entries._entries.size();
+        int index = previousLogIndex + 1;
+        while (index < new_entries_end && index < (int)this->_server_log.size()
+               && this->_server_log.term_at(index) == new_entries._entries.at(index - (previousLogIndex + 1))._term)
+        {
+            index++;
+        }
 
-        // Setting up variables for the loop
-        int i = previousLogIndex + 1;
+        // The conflicting entry and all the entries following it are removed from the logs and from the write-ahead log
+        // (if all the new entries are already in the logs, the following entries are kept as the query may be an old one)
+        if (index < new_entries_end && index < (int)this->_server_log.size())
+        {
+            this->_server_log.truncate(index);
+            this->_write_ahead_log.truncate(index);
+        }
+        for (; index < new_entries_end; index++)
+        {
+            this->_server_log.append(new_entries._entries.at(index - (previousLogIndex + 1)));
+            this->_write_ahead_log.append(index, this->_server_log.back());
+        }
 
-        // Then now we are going to copy the rest of the new entries in our logs
-        // Defining a variable to determine if there is any conflict during the copy of the new log entries
-        bool conflict = false;
-        for (; i < (int)new_entries._entries.size() + previousLogIndex + 1;  i++)
+        // If the leader commit index is superior to the server commit index
+        // Then set the commit index to the minimum between the leader's one and the index of last new entry
+        // (the entries kept after the new ones may not match the leader logs)
+        if (new_entries._leader_commit > this->_commit_index)
         {
-            const LogEntry& new_entry = new_entries._entries.at(i - (previousLogIndex + 1));
+            this->_commit_index = std::min(new_entries._leader_commit, new_entries_end - 1);
+        }
+        this->update_leader(new_entries._leader_rank, new_entries._leader_commit);
 
-            if (i < (int)this->_server_log.size() && !conflict)
-            {
-                const LogEntry& old_entry = this->_server_log.at(i);
+        // The response saying that the queries has been appened correctly is sent once the entries are written in the write-ahead log
+        const int match_index = new_entries._prev_log_index + new_entries._entries.size();
+        this->_pending_responses.emplace_back(new_entries._leader_rank, AppendEntriesResponse(new_entries._term, true, match_index));
+    }
+}
 
-                // Checking if the new and old entry have the same term,  then there is a conflict
-                conflict = old_entry._term != new_entry._term;
+void Server::handle_install_snapshot(const Query& query)
+{
+    const InstallSnapshot& install_snapshot = std::get<InstallSnapshot>(query._content);
 
-                // If there is no conflict, then add the old_entry
-                if (!conflict)
-                {
-                    new_logs.push_back(old_entry);
-                }
-            }
-            // If there is a conflict, ignore the rest of the old logs and add the new entries
-            else
-            {
-                new_logs.push_back(new_entry);
-            }
+    // If the query term is inferior to the server term, then deny query
+    if (install_snapshot._term < this->_current_term)
+    {
+        send_message(InstallSnapshotResponse(this->_current_term, false, -1, 0), install_snapshot._leader_rank, 0);
+        return;
+    }
+    this->_clock.reset();
+    this->_leader_rank = install_snapshot._leader_rank;
+
+    // If the entries of the snapshot are already committed by the server, its logs already match the snapshot
+    const int last_included_index = install_snapshot._last_included_index;
+    if (last_included_index > this->_commit_index)
+    {
+        // The chunk is written in the part file if it follows the state already received (the chunks received before a crash are kept)
+        size_t received_size = this->_snapshot_store.received_size(last_included_index, install_snapshot._last_included_term);
+        const size_t chunk_end = install_snapshot._offset + install_snapshot._data.size();
+        if (install_snapshot._offset <= received_size
+            && this->_snapshot_store.write_chunk(last_included_index, install_snapshot._last_included_term, install_snapshot._offset, install_snapshot._data))
+        {
+            received_size = std::max(received_size, chunk_end);
         }
 
-        // Replacing the old logs by the new ones
-        this->_server_log.swap(new_logs);
+        // Until the last chunk is received, the leader is asked for the chunk following the received state
+        // The snapshot is installed before changing the logs, so that the server can restore it after a crash
+        SnapshotStore::Snapshot snapshot;
+        if (!install_snapshot._done || received_size != chunk_end
+            || !this->_snapshot_store.install_received(last_included_index, install_snapshot._last_included_term, install_snapshot._crc, snapshot))
+        {
+            received_size = install_snapshot._done && received_size == chunk_end ? 0 : received_size;
+            send_message(InstallSnapshotResponse(install_snapshot._term, false, last_included_index, received_size), install_snapshot._leader_rank, 0);
+            return;
+        }
 
-        // If the leader commit index is superior to the server commit index
-        // Then set the commit index to the minimum between the leader's one and the index of last new entry
-        if (new_entries._leader_commit > this->_commit_index)
+        // The entries following the snapshot are kept if the logs have the last entry of the snapshot, otherwise all the logs are replaced
+        if (this->_server_log.term_at(last_included_index) == snapshot._last_included_term)
+        {
+            this->_server_log.compact(last_included_index);
+            this->_write_ahead_log.compact(last_included_index);
+        }
+        else
         {
-            this->_commit_index = std::min(new_entries._leader_commit, (int)this->_server_log.size() - 1);
+            this->_server_log.reset(last_included_index, snapshot._last_included_term);
+            this->_write_ahead_log.clear();
         }
 
-        // Send the response saying that the queries has been appened correctly
-        send_message(AppendEntriesResponse(new_entries._term, true), new_entries._leader_rank, 0);
+        // The state of the snapshot replaces the state of the server, as all its entries are applied
+        this->_snapshot = snapshot;
+        this->install_state();
+        this->_commit_index = last_included_index;
+        this->_last_log_applied = last_included_index;
     }
+
+    send_message(InstallSnapshotResponse(install_snapshot._term, true, last_included_index, 0), install_snapshot._leader_rank, 0);
 }
 
 void Server::handle_message(const Query& query) 
@@ -418,11 +1033,18 @@ void Server::handle_message(const Query& query)
                 // Reseting his settings to make sure that it won't have the same when recovering (to avoid confusion)
                 this->_status = ServerStatus::DEAD;
                 this->_vote_count = 0;
-                this->_entries_queue = std::queue<Query>();
+                this->_entries_queue.clear();
+                this->_forwarded_entries.clear();
                 this->_current_term = 0;
                 this->_voted_for = 0;
+                this->_leader_rank = 0;
                 this->_next_log_index = std::vector<int>(this->_servers_count, 0);
                 this->_log_index_match = std::vector<int>(this->_servers_count, -1);
+                // The responses that are not written yet and the reads that are not answered yet are lost with the crash
+                this->_pending_responses.clear();
+                this->_pending_votes.clear();
+                // (the read rounds are kept, so that a response to a round sent before the crash does not match a later one)
+                this->_pending_reads.clear();
             }
             else
             {
@@ -436,7 +1058,9 @@ void Server::handle_message(const Query& query)
             if (this->_status == ServerStatus::DEAD)
             {
                 // Recover a server to set him as follower (a server with DEAD status)
+                // Its term and its vote are read from its metadata, as they were lost with the crash
                 this->set_as_follower();
+                this->load_metadata();
             }
             else
             {
@@ -476,42 +1100,203 @@ void Server::handle_message(const Query& query)
     send_message(message_response, query._source_rank, 0);
 }
 
-void Server::handle_queries(std::vector<Query> received_queries) 
+void Server::apply_committed_entries()
 {
-    // Applying all the logs that need to be applied to the server logs
-    while (this->_commit_index > this->_last_log_applied)
+    if (this->_commit_index <= this->_last_log_applied)
+    {
+        return;
+    }
+
+    // All the committed entries are applied to the state machine at once (the commands are views in the logs, which do not change meanwhile)
+    std::vector<LogEntryView> entries;
+    entries.reserve(this->_commit_index - this->_last_log_applied);
+    for (int index = this->_last_log_applied + 1; index <= this->_commit_index; index++)
+    {
+        entries.push_back(this->_server_log.at(index));
+    }
+    std::vector<std::string> results;
+    results.reserve(entries.size());
+    if (this->_applied_entries_count == 0)
+    {
+        this->_apply_clock.reset();
+    }
+    this->_state_machine->apply(entries, results);
+    this->_applied_entries_count += entries.size();
+    this->_apply_duration = this->_apply_clock.check();
+
+    for (size_t i = 0; i < entries.size(); i++)
     {
         this->_last_log_applied += 1;
 
-        std::ofstream logs_file;
-        logs_file.open(this->_log_filepath, std::ofstream::app);
-        if (logs_file.good())
+        // The batches of the clients that were replaced by the ones of another leader are removed from the queue
+        // (the applied entries may also come from a previous leader or from the restored logs, and have no client waiting for them)
+        while (!this->_entries_queue.empty() && this->_entries_queue.begin()->second._last_log_index < this->_last_log_applied)
         {
-            logs_file << this->_server_log.at(this->_last_log_applied)._command << std::endl;
+            this->_entries_queue.erase(this->_entries_queue.begin());
         }
-        else
+        if (this->_status != ServerStatus::LEADER || this->_entries_queue.empty() || this->_entries_queue.begin()->first > this->_last_log_applied)
+        {
+            continue;
+        }
+
+        // An entry of the batch was replaced by the one of another leader, so the batch is not acknowledged
+        ClientEntry& client_entry = this->_entries_queue.begin()->second;
+        if (client_entry._term != entries.at(i)._term)
         {
-            std::cerr << "Server " << this->_rank << " is unable to open file : " << this->_log_filepath << std::endl;
+            this->_entries_queue.erase(this->_entries_queue.begin());
+            continue;
         }
-        logs_file.close();
 
-        // If this is the leader, then send a Reponse saying that the entry has been applied corretly
-        if (this->_status == ServerStatus::LEADER)
+        // If this is the leader, then send a single Reponse with the results of the batch once its last entry has been applied
+        client_entry._results.push_back(std::move(results.at(i)));
+        if (client_entry._last_log_index == this->_last_log_applied)
         {
-            Query entry_query = this->_entries_queue.front();
-            send_message(NewLogEntryResponse(true), entry_query._source_rank, 0);
-            this->_entries_queue.pop();
+            send_message(NewLogEntryResponse(client_entry._request_id, true, std::move(client_entry._results)), client_entry._client_rank, 0);
+            this->_entries_queue.erase(this->_entries_queue.begin());
         }
     }
 
+    // Taking a snapshot of the applied entries once there are enough of them in the logs
+    const int applied_entries_count = this->_last_log_applied - ((int)this->_server_log.first_index() - 1);
+    if (this->_config.snapshot_threshold > 0 && applied_entries_count >= this->_config.snapshot_threshold)
+    {
+        this->take_snapshot();
+    }
+}
+
+// ========== Snapshot functions ==========
+
+// The state machine writes its state in the state file, which is then copied in the snapshot by chunks
+void Server::take_snapshot()
+{
+    const int last_included_index = this->_last_log_applied;
+    const bool stored = this->_state_machine->snapshot(this->_state_filepath)
+                        && this->_snapshot_store.store(last_included_index, this->_server_log.term_at(last_included_index), this->_state_filepath, this->_snapshot);
+    std::remove(this->_state_filepath.c_str());
+    if (!stored)
+    {
+        return;
+    }
+
+    // The entries of the snapshot can now be removed from the logs and from the write-ahead log
+    this->_server_log.compact(last_included_index);
+    this->_write_ahead_log.compact(last_included_index);
+
+    // The followers receiving the previous snapshot will receive this one from the beginning
+    std::fill(this->_snapshot_offsets.begin(), this->_snapshot_offsets.end(), 0);
+}
+
+void Server::install_state()
+{
+    if (!this->_snapshot_store.restore_state(this->_state_filepath) || !this->_state_machine->restore(this->_state_filepath))
+    {
+        std::cerr << "Server " << this->_rank << " is unable to restore its state from its snapshot." << std::endl;
+    }
+    std::remove(this->_state_filepath.c_str());
+}
+
+void Server::flush_write_ahead_log()
+{
+    // A crashed server does not write anything (its term and its vote are reset in memory, they must stay the stored ones for its recovery)
+    if (this->_status == ServerStatus::DEAD)
+    {
+        return;
+    }
+
+    // All the entries appended since the last flush are written with a single write and sync (group commit)
+    // This is also done without new entries, to sync the last records once the sync interval is over
+    // The metadata are written with the same batch, so the votes and the acknowledgements of the update wait for a single flush
+    if (!this->_write_ahead_log.flush() || !this->persist_metadata())
+    {
+        // The entries are not durable, so they are not acknowledged (the leader will send them again)
+        this->_pending_responses.clear();
+        this->_pending_votes.clear();
+        return;
+    }
+    this->_flushed_log_index = (int)this->_server_log.size() - 1;
+
+    for (const auto& [leader_rank, response] : this->_pending_responses)
+    {
+        send_message(response, leader_rank, 0);
+    }
+    this->_pending_responses.clear();
+    for (const auto& [candidate_rank, vote] : this->_pending_votes)
+    {
+        send_message(vote, candidate_rank, 0);
+    }
+    this->_pending_votes.clear();
+}
+
+bool Server::persist_metadata()
+{
+    MetadataStore::Metadata metadata;
+    metadata._current_term = this->_current_term;
+    metadata._voted_for = this->_voted_for;
+    metadata._commit_index = this->_commit_index;
+
+    // The term and the vote are written as soon as they change, the commit index is only a hint to apply the entries after a restart
+    const bool vote_changed = metadata._current_term != this->_stored_metadata._current_term || metadata._voted_for != this->_stored_metadata._voted_for;
+    const bool commit_changed = metadata._commit_index != this->_stored_metadata._commit_index;
+    if (!vote_changed && !(commit_changed && this->_metadata_clock.check() > this->_commit_persist_timeout))
+    {
+        return true;
+    }
+
+    if (!this->_metadata_store.store(metadata))
+    {
+        return false;
+    }
+    this->_stored_metadata = metadata;
+    this->_metadata_clock.reset();
+    return true;
+}
+
+void Server::load_metadata()
+{
+    MetadataStore::Metadata metadata;
+    if (!this->_metadata_store.load(metadata))
+    {
+        std::cerr << "Server " << this->_rank << " could not read its metadata." << std::endl;
+    }
+    this->_stored_metadata = metadata;
+
+    // The current term of the server can not be lower than the term of its last entry
+    const int last_log_term = this->_server_log.last_term();
+    this->_current_term = std::max(metadata._current_term, last_log_term);
+    this->_voted_for = metadata._voted_for;
+    // The entries until the commit index are committed, so they can be applied directly
+    this->_commit_index = std::max(this->_commit_index, std::min(metadata._commit_index, (int)this->_server_log.size() - 1));
+}
+
+void Server::handle_queries(std::vector<Query> received_queries) 
+{
+    // Applying all the logs that need to be applied to the server logs
+    this->apply_committed_entries();
+
     for (const Query& query : received_queries)
     {
+        // With the lease reads, the leader answers the reads until the minimum election timeout after its round of heartbeats
+        // So a follower ignores the vote requests until the minimum election timeout is over since it heard from the leader
+        // (the leader itself steps down on the vote request, so the candidate is elected once the followers stop hearing from it)
+        // The time is the one since the last message of the leader, as the election clock is also reset by the vote requests
+        if (this->_config.lease_read && query._type == RPC::RPC_TYPE::VOTE_REQUEST && this->_status == ServerStatus::FOLLOWER
+            && this->_leader_rank != 0 && this->_leader_message_clock.check() < this->_min_election_timeout)
+        {
+            continue;
+        }
         // Check the term of the query if the server is not dead in a first place to update it
         if (this->_status != ServerStatus::DEAD && query._term > this->_current_term)
         {
             this->_current_term = query._term;
+            this->_leader_rank = 0;
             this->set_as_follower();
         }
+        // Keeping the time of the last message of the leader of the current term
+        if (this->_status == ServerStatus::FOLLOWER && query._term == this->_current_term
+            && (query._type == RPC::RPC_TYPE::HEARTBEAT || query._type == RPC::RPC_TYPE::APPEND_ENTRIES || query._type == RPC::RPC_TYPE::INSTALL_SNAPSHOT))
+        {
+            this->_leader_message_clock.reset();
+        }
         // Checking if the type of the query is a Message to handle it 
         if (query._type == RPC::RPC_TYPE::MESSAGE)
         {
@@ -531,9 +1316,21 @@ void Server::handle_queries(std::vector<Query> received_queries)
                     {
                         this->_voted_for = 0;
                     }
-                    if (heartbeat._leader_commit > this->_commit_index)
+                    // The entries are only committed until the previous entry of the heartbeat, if it matches the leader logs
+                    // (the entries following it may be old entries that were not removed yet)
+                    if (heartbeat._leader_commit > this->_commit_index && heartbeat._prev_log_index < (int)this->_server_log.size()
+                        && this->_server_log.term_at(heartbeat._prev_log_index) == heartbeat._prev_log_term)
+                    {
+                        this->_commit_index = std::max(this->_commit_index, std::min(heartbeat._leader_commit, heartbeat._prev_log_index));
+                    }
+                    if (heartbeat._term == this->_current_term)
+                    {
+                        this->update_leader(heartbeat._leader_rank, heartbeat._leader_commit);
+                    }
+                    // The heartbeats of a round of reads are answered, so that the leader knows that it is still the leader
+                    if (heartbeat._read_round != 0)
                     {
-                        this->_commit_index = std::min(heartbeat._leader_commit, (int)this->_server_log.size() - 1);
+                        send_message(HeartbeatResponse(this->_current_term, heartbeat._read_round), heartbeat._leader_rank, 0);
                     }
                     // Reseting the clock
                     this->_clock.reset();
@@ -544,6 +1341,11 @@ void Server::handle_queries(std::vector<Query> received_queries)
                     this->handle_new_entries(query);
                     break;
                 }
+                case RPC::RPC_TYPE::INSTALL_SNAPSHOT:
+                {
+                    this->handle_install_snapshot(query);
+                    break;
+                }
                 case RPC::RPC_TYPE::VOTE_REQUEST:
                 {
                     handle_vote_request(query);
@@ -553,24 +1355,77 @@ void Server::handle_queries(std::vector<Query> received_queries)
                 }
                 case RPC::RPC_TYPE::SEARCH_LEADER:
                 {
+                    // The followers also answer with the leader they know (from its heartbeats), so the client does not wait for the leader
                     if (this->_status == ServerStatus::LEADER)
                     {
                         SearchLeaderResponse leader_response = SearchLeaderResponse(this->_rank);
                         send_message(leader_response, query._source_rank, 0);
                     }
+                    else if (this->_status == ServerStatus::FOLLOWER && this->_leader_rank != 0)
+                    {
+                        send_message(SearchLeaderResponse(this->_leader_rank), query._source_rank, 0);
+                    }
                     break;
                 }
                 case RPC::RPC_TYPE::NEW_LOG_ENTRY:
                 {
                     // If this is not the leader, deny the query as only the leader can interact with clients
                     // We need here to answer the query as this will tell the clients that his leader rank is outdated
-                    if (this->_status != ServerStatus::LEADER)
+                    // The leader known by the server is sent as a hint, so the client sends the entries again to it without searching it
+                    // If the proposals are forwarded, a follower that knows the leader sends the entries to it instead
+                    if (this->_config.forward_proposals && this->_status == ServerStatus::FOLLOWER && this->_leader_rank != 0)
                     {
-                        NewLogEntryResponse new_log_entry_response = NewLogEntryResponse(false);
+                        this->forward_entries(query);
+                    }
+                    else if (this->_status != ServerStatus::LEADER)
+                    {
+                        const NewLogEntry& new_entry = std::get<NewLogEntry>(query._content);
+                        NewLogEntryResponse new_log_entry_response = NewLogEntryResponse(new_entry._request_id, false, {}, this->_leader_rank);
                         send_message(new_log_entry_response, query._source_rank, 0);
                     }
                     break;
                 }
+                case RPC::RPC_TYPE::NEW_LOG_ENTRY_RESPONSE:
+                {
+                    // Response of the leader to entries forwarded by this server
+                    this->handle_forwarded_response(std::get<NewLogEntryResponse>(query._content));
+                    break;
+                }
+                case RPC::RPC_TYPE::READ_REQUEST:
+                {
+                    // Only the leader can answer the reads, as the other servers may not have the last committed entries
+                    // With the follower reads, the followers also answer them once they know the read index of the leader
+                    // The stale reads are answered with the last commit index of the leader if it was received less than the maximum staleness ago
+                    const ReadRequest& read_request = std::get<ReadRequest>(query._content);
+                    if (this->_config.follower_reads && this->_status == ServerStatus::FOLLOWER)
+                    {
+                        const bool fresh = this->_leader_rank != 0 && this->_leader_commit_clock.check() <= this->_config.max_staleness;
+                        const int read_index = read_request._stale && fresh ? this->_leader_commit_index : UNKNOWN_READ_INDEX;
+                        this->_pending_reads.push_back(PendingRead{query._source_rank, read_request._request_id, std::string(read_request._query), read_index, 0, 0});
+                    }
+                    else if (this->_status != ServerStatus::LEADER)
+                    {
+                        send_message(ReadResponse(read_request._request_id, false, std::string(), this->_leader_rank), query._source_rank, 0);
+                    }
+                    break;
+                }
+                case RPC::RPC_TYPE::READ_INDEX_REQUEST:
+                {
+                    if (this->_status != ServerStatus::LEADER)
+                    {
+                        const ReadIndexRequest& request = std::get<ReadIndexRequest>(query._content);
+                        send_message(ReadIndexResponse(this->_current_term, request._read_round, -1), query._source_rank, 0);
+                    }
+                    break;
+                }
+                case RPC::RPC_TYPE::READ_INDEX_RESPONSE:
+                {
+                    if (this->_status == ServerStatus::FOLLOWER)
+                    {
+                        this->handle_read_index_response(std::get<ReadIndexResponse>(query._content));
+                    }
+                    break;
+                }
                 default:
                     break;
             }
@@ -578,14 +1433,134 @@ void Server::handle_queries(std::vector<Query> received_queries)
     }
 }
 
+// ========== Forwarding functions ==========
+
+// The entries are forwarded with a request id of the follower, and the response of the leader is sent back to the client with its own request id
+// The entries keep the session of their client, so the leader applies them only once even if the client also sends them to another server
+void Server::forward_entries(const Query& query)
+{
+    const NewLogEntry& new_entry = std::get<NewLogEntry>(query._content);
+    // The entries sent again by the client while they are forwarded are not forwarded a second time (the leader answers them once)
+    for (const auto& [forward_id, forwarded] : this->_forwarded_entries)
+    {
+        if (forwarded._client_rank == query._source_rank && forwarded._request_id == new_entry._request_id)
+        {
+            return;
+        }
+    }
+    const int forward_id = this->_next_forward_id++;
+    this->_forwarded_entries.emplace(forward_id, ForwardedEntries{query._source_rank, new_entry._request_id, this->_leader_rank, this->_current_term});
+    send_message(NewLogEntry(forward_id, new_entry._log_entries), this->_leader_rank, 0);
+}
+
+void Server::handle_forwarded_response(const NewLogEntryResponse& response)
+{
+    auto forwarded = this->_forwarded_entries.find(response._request_id);
+    if (forwarded == this->_forwarded_entries.end())
+    {
+        return;
+    }
+    // The leader that answered is sent as a hint with the results, so that the client sends its next entries to it directly
+    const size_t leader_hint = response._success ? forwarded->second._leader_rank : response._leader_hint;
+    send_message(NewLogEntryResponse(forwarded->second._request_id, response._success, response._results, leader_hint), forwarded->second._client_rank, 0);
+    this->_forwarded_entries.erase(forwarded);
+}
+
+void Server::deny_forwarded_entries()
+{
+    for (auto forwarded = this->_forwarded_entries.begin(); forwarded != this->_forwarded_entries.end();)
+    {
+        if (this->_status == ServerStatus::FOLLOWER && forwarded->second._leader_rank == this->_leader_rank
+            && forwarded->second._term == this->_current_term)
+        {
+            forwarded++;
+            continue;
+        }
+        const int leader_hint = this->_status == ServerStatus::FOLLOWER ? this->_leader_rank : 0;
+        send_message(NewLogEntryResponse(forwarded->second._request_id, false, {}, leader_hint), forwarded->second._client_rank, 0);
+        forwarded = this->_forwarded_entries.erase(forwarded);
+    }
+}
+
+bool Server::handle_duplicate_entries(const Query& query, const NewLogEntry& new_entry)
+{
+    // The entries of a batch have consecutive sequence numbers in the session of their client, and they are appended together
+    const LogEntryView& first_entry = new_entry._log_entries.front();
+    const int count = new_entry._log_entries.size();
+    if (first_entry._client_id == 0)
+    {
+        return false;
+    }
+
+    // If the batch is already applied, its results are the ones kept in the session of the client
+    std::vector<std::string> results;
+    if (this->_state_machine->applied_results(first_entry._client_id, first_entry._sequence, count, results))
+    {
+        send_message(NewLogEntryResponse(new_entry._request_id, true, std::move(results)), query._source_rank, 0);
+        return true;
+    }
+
+    // Otherwise, the batch is searched in the logs from their end, until its last entry would be applied
+    const int lowest_index = std::max((int)this->_server_log.first_index(), this->_last_log_applied + 2 - count);
+    for (int index = (int)this->_server_log.size() - count; index >= lowest_index; index--)
+    {
+        const LogEntryView entry = this->_server_log.at(index);
+        if (entry._client_id != first_entry._client_id || entry._sequence != first_entry._sequence)
+        {
+            continue;
+        }
+        const LogEntryView last_entry = this->_server_log.at(index + count - 1);
+        if (last_entry._client_id != first_entry._client_id || last_entry._sequence != first_entry._sequence + count - 1)
+        {
+            return false;
+        }
+
+        // The response of the batch is sent to its last sender only (the previous one was denied, or does not wait for it anymore)
+        auto client_entry = this->_entries_queue.find(index);
+        if (client_entry != this->_entries_queue.end())
+        {
+            client_entry->second._client_rank = query._source_rank;
+            client_entry->second._request_id = new_entry._request_id;
+            return true;
+        }
+        // The batch may also have been appended by a previous leader, nobody waits for it then (its results are only gathered if none is applied yet)
+        if (index <= this->_last_log_applied)
+        {
+            return false;
+        }
+        this->_entries_queue.emplace(index, ClientEntry{index, index + count - 1, entry._term, query._source_rank, new_entry._request_id, {}});
+        return true;
+    }
+    return false;
+}
+
 // ========== Update and run function ==========
 
 void Server::update() 
 {
     std::vector<Query> received_queries;
-    receive_all_messages(this->_rank, (this->_servers_count + this->_clients_count + 1), 0, received_queries, 0);
+    receive_all_messages(received_queries, 0, this->_config.receive_budget);
     handle_queries(received_queries);
 
+    // Writing the entries appended by the follower in the write-ahead log before acknowledging them
+    this->flush_write_ahead_log();
+
+    // The reads waiting for a server that is not the leader anymore are denied, so that the clients send them to the new leader
+    // With the follower reads, the followers answer their reads themselves
+    // A crashed server does not answer anything (its reads and its forwarded entries are dropped with the crash)
+    if (this->_status == ServerStatus::FOLLOWER && this->_config.follower_reads)
+    {
+        this->handle_follower_reads();
+    }
+    else if (this->_status != ServerStatus::LEADER && this->_status != ServerStatus::DEAD)
+    {
+        this->deny_reads();
+    }
+    if (this->_status != ServerStatus::DEAD)
+    {
+        this->deny_forwarded_entries();
+    }
+
     switch (this->_status)
     {
         case ServerStatus::FOLLOWER:
@@ -613,12 +1588,41 @@ void Server::update()
     }
 }
 
+float Server::next_timeout()
+{
+    // The other timers (retransmissions, syncs of the write-ahead log...) are checked at least every heartbeat timeout
+    float timeout = this->_heartbeat_timeout;
+    switch (this->_status)
+    {
+        case ServerStatus::FOLLOWER:
+        case ServerStatus::CANDIDATE:
+        {
+            timeout = std::min(timeout, this->_election_timeout - this->_clock.check());
+            break;
+        }
+        case ServerStatus::LEADER:
+        {
+            timeout = std::min(timeout, this->_heartbeat_timeout - this->_clock.check());
+            if (this->_batch_pending)
+            {
+                timeout = std::min(timeout, (this->_config.batch_window - this->_batch_clock.check_microseconds()) / 1000);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+    return std::max(timeout, 0.0f);
+}
+
 void Server::run_server() 
 {
     while (!this->_is_stopped)
     {
-        // Waiting depending on the speed of the server
-        this->_clock.wait((int)this->_server_speed);
+        // Waiting for the next message or the next timer, whichever comes first
+        wait_for_message(0, this->next_timeout(), this->_config.busy_poll ? 0 : this->_config.poll_interval);
+        // Waiting depending on the speed of the server (the delay is injected before handling the message or the timer)
+        Clock::wait((int)this->_server_speed);
 
         // Updating the server (handling the queries, elections, timeout...)
         this->update();
@@ -633,5 +1637,10 @@ std::ostream& operator<< (std::ostream& out, const Server& server)
     out << "Server rank : " << server._rank << ", Server status : " << status_map.at((int)server._status);
     out << ", Server timeout : " << server._election_timeout << ", Server term : " << server._current_term;
     out << ", Server speed : " << speed_map.at((int)server._server_speed); 
+    out << ", Applied entries : " << server._applied_entries_count;
+    if (server._apply_duration > 0)
+    {
+        out << " (" << server._applied_entries_count * 1000 / server._apply_duration << " entries/s)";
+    }
     return out;
 }
\ No newline at end of file
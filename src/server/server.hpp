@@ -1,23 +1,32 @@
 #pragma once
 
 #include <algorithm>
+#include <deque>
+#include <functional>
 #include <cstdlib>
+#include <limits>
 #include <iostream>
 #include <map>
 #include <fstream>
-#include <queue>
+#include <memory>
 #include <vector>
 
 #include "mpi.h"
 #include "clock/clock.hpp"
 #include "rpc/entries/log_entry.hpp"
+#include "log/server_log.hpp"
+#include "log/write_ahead_log.hpp"
+#include "log/metadata_store.hpp"
+#include "log/snapshot_store.hpp"
 #include "rpc/query/query.hpp"
 #include "message/message.hpp"
+#include "server/server_config.hpp"
+#include "state_machine/session_state_machine.hpp"
 
 enum class ServerStatus { FOLLOWER, CANDIDATE, LEADER, DEAD };
 enum class ServerSpeed 
 {
-    // The speed is linked to the delay that the server will wait before each update
+    // The speed is linked to the delay that the server will wait before each update (once a message arrived or a timer is over)
     // So the more the server is fast, the less the delay is high
     HIGH = 0,
     MEDIUM = 250,
@@ -28,7 +37,7 @@ class Server
 {
 public:
     // Constructor
-    Server(int rank, int servers_count, int clients_count);
+    Server(int rank, int servers_count, int clients_count, const ServerConfig& config);
 
     // Core functions
     void run_server();
@@ -47,14 +56,59 @@ private:
     void candidate_routine(const std::vector<Query>& queries);
     void leader_routine(const std::vector<Query>& queries);
 
+    // Replication functions (the pipelined replication is used by the leader if the pipeline window is not 0)
+    void replicate_to_followers(bool send_heartbeats);
+    void replicate_pipelined(bool send_entries);
+    void handle_append_entries_response(size_t server_rank, const AppendEntriesResponse& response);
+    void send_snapshot(size_t server_rank);
+    void handle_install_snapshot_response(size_t server_rank, const InstallSnapshotResponse& response);
+    void advance_commit_index();
+
+    // Read functions (the reads are answered once the leader confirmed that it is still the leader, see ReadIndex)
+    void start_read_round();
+    void handle_heartbeat_response(size_t server_rank, const HeartbeatResponse& response);
+    void handle_reads();
+    // Function used by the followers to get the read index of their reads from the leader, and to answer them once it is applied
+    void handle_follower_reads();
+    void handle_read_index_response(const ReadIndexResponse& response);
+    // Function used to deny all the pending reads (when the server can not answer them anymore)
+    void deny_reads();
+    // Function used by the followers to keep the leader, and the time at which they had all the entries committed by the leader (stale reads)
+    void update_leader(size_t leader_rank, int leader_commit);
+
+    // Forwarding functions (the followers forward the entries of the clients to the leader if the proposals are forwarded)
+    void forward_entries(const Query& query);
+    void handle_forwarded_response(const NewLogEntryResponse& response);
+    // Function used to deny the forwarded entries whose leader is not the known leader of the current term anymore (all of them if the server is not a follower)
+    void deny_forwarded_entries();
+    // Function used by the leader to answer a batch of a client that is already in its logs (sent again by the client, or forwarded by a follower),
+    // instead of appending it a second time : returns false if the batch is not in the logs
+    bool handle_duplicate_entries(const Query& query, const NewLogEntry& new_entry);
+
     // Queries handling functions
     void handle_vote_request(const Query& query);
     void handle_new_entries(const Query& query);
+    void handle_install_snapshot(const Query& query);
     void handle_message(const Query& query);
     void handle_queries(std::vector<Query> received_queries);
+    void apply_committed_entries();
+
+    // Snapshot functions (the snapshot is taken once there are snapshot threshold applied entries in the logs)
+    void take_snapshot();
+    // Function used to replace the state of the state machine by the state of the snapshot
+    void install_state();
+
+    // Function used to write the new entries in the write-ahead log and the metadata, and to send the responses waiting for them
+    void flush_write_ahead_log();
+    // Function used to write the metadata of the server if they changed (the commit index is only written every commit persist timeout)
+    bool persist_metadata();
+    // Function used to read the metadata of the server (when it is restarting or recovering)
+    void load_metadata();
 
     // Update function (to update the server status, send and receive queries)
     void update();
+    // Function used to get the time (in milliseconds) until the next timer of the server, the server waits for a message until then
+    float next_timeout();
 
     // ===== Server class privates variables =====
 
@@ -64,18 +118,31 @@ private:
     ServerStatus _status;
     // Current term of the server (initialized to 1)
     int _current_term;
-    // Filepath of the log of the server
-    std::string _log_filepath;
+    // State machine to which the committed entries are applied (the log file of the server, or the key-value store)
+    std::unique_ptr<SessionStateMachine> _state_machine;
+    // Filepath of the file where the state of the state machine is written to be copied in a snapshot (and read from it)
+    std::string _state_filepath;
+    // Number of entries applied since the server started, and time between the first and the last applied entries (to get the applied entries per second)
+    size_t _applied_entries_count;
+    float _apply_duration;
+    Clock _apply_clock;
+    // Options of the server
+    ServerConfig _config;
 
     // Server speed (the time that the server will wait between each updata)
     ServerSpeed _server_speed;
 
     // Clock to detect the timeout
     Clock _clock;
-    // Timeout for the election of the node (switch to candidate and start election)
+    // Timeout for the election of the node (switch to candidate and start election), and the minimum timeout of all the servers
     float _election_timeout;
+    float _min_election_timeout;
     // Timeout for the heartbeat of the node
     float _heartbeat_timeout;
+    // Timeout after which the entries sent to a follower and not acknowledged are sent again (pipelined replication)
+    float _retransmit_timeout;
+    // Timeout after which the commit index is written in the metadata even if the term and the vote did not change
+    float _commit_persist_timeout;
 
     // Vote of the server for the leader election
     size_t _voted_for;
@@ -90,12 +157,43 @@ private:
     // Value saying if the server is completely stop or not
     bool _is_stopped;
 
-    // Queue of the entries of the server
-    std::queue<Query> _entries_queue;
+    // Batch of entries of a client waiting to be applied (the indexes and the term are used to check that the applied entries are the ones of the client)
+    // The results of the entries are gathered until the last one of the batch is applied
+    struct ClientEntry
+    {
+        int _first_log_index;
+        int _last_log_index;
+        int _term;
+        size_t _client_rank;
+        int _request_id;
+        std::vector<std::string> _results;
+    };
+    // Batches of the clients waiting to be applied, by their first log index (in the order of the logs)
+    // Only the rank is kept so that the received queries (and their receive buffers) are not kept until the entries are applied
+    std::map<int, ClientEntry> _entries_queue;
     
     // Log entries of the server
     // Each entry contains command for state machine, and the term when this log entry was received by leader (the first index is 1)
-    std::vector<LogEntry> _server_log;
+    ServerLog _server_log;
+    // Write-ahead log of the server, the entries are written in it before being acknowledged
+    WriteAheadLog _write_ahead_log;
+    // Index of the last entry written in the write-ahead log (the leader only counts itself in the majority for these entries)
+    int _flushed_log_index;
+    // Responses to the AppendEntries waiting for their entries to be written in the write-ahead log (with the rank of the leader)
+    std::vector<std::pair<size_t, AppendEntriesResponse>> _pending_responses;
+    // Votes waiting for the metadata to be written (with the rank of the candidate)
+    std::vector<std::pair<size_t, VoteResponse>> _pending_votes;
+
+    // Store of the term, the vote and the commit index of the server
+    MetadataStore _metadata_store;
+    // Store of the last snapshot of the server, and this snapshot (kept to be sent to the followers)
+    SnapshotStore _snapshot_store;
+    SnapshotStore::Snapshot _snapshot;
+    // For each server, offset of the next chunk of the state of the snapshot to send to that server
+    std::vector<size_t> _snapshot_offsets;
+    // Last metadata written in the store, and clock started when they were written
+    MetadataStore::Metadata _stored_metadata;
+    Clock _metadata_clock;
     // Index of highest log entry known to be committed (initialized to 0, increase monotonically)
     int _commit_index;
     // Index of highest log entry applied to state machine (initialized to 0, increase monotonically)
@@ -104,4 +202,64 @@ private:
     std::vector<int> _next_log_index;
     // For each server, indicate the index of the highest log entry known to be replicated on a the server of the index (initialized to 0, increase monotonically)
     std::vector<int> _log_index_match;
+    // For each server, indicate the index of the next log entry that was not sent yet to that server (pipelined replication)
+    // The entries from the next log index to this one are sent and waiting to be acknowledged
+    std::vector<int> _sent_log_index;
+    // For each server, clock used to send again the entries that are not acknowledged in time (pipelined replication)
+    std::vector<Clock> _replication_clocks;
+    // True if the leader received new entries that are not sent yet to the followers (eager and pipelined replication)
+    bool _batch_pending;
+    // Clock started with the first new entry of the batch, the batch is sent once the batch window is over
+    Clock _batch_clock;
+
+    // Read index of the reads whose read index is not known yet
+    static constexpr int UNKNOWN_READ_INDEX = std::numeric_limits<int>::max();
+    // Read of a client (or read index request of a follower) waiting to be answered
+    // The read index is the commit index when the round confirming the leadership started, the read is answered once it is applied
+    struct PendingRead
+    {
+        size_t _source_rank;
+        int _request_id;
+        std::string _query;
+        int _read_index;
+        // Round of heartbeats confirming the leadership for this read (0 if the round is not started yet)
+        // On a follower, this is the read index request sent to the leader for this read
+        int _read_round;
+        // Read index request of the follower (0 for the reads of the clients), answered with the read index instead of the result
+        int _follower_read_round;
+    };
+    // Reads waiting to be answered (in the order of the rounds)
+    std::deque<PendingRead> _pending_reads;
+    // Last round of heartbeats started by the leader, and last round acknowledged by the majority of the servers
+    // On a follower, these are the last read index request sent to the leader and the last one answered
+    int _read_round;
+    int _confirmed_read_round;
+    // For each server, last round of heartbeats acknowledged by that server
+    std::vector<int> _read_round_acks;
+    // Clock started when the last round is started (a new round is started if it is not confirmed in time)
+    Clock _read_round_clock;
+    // Clock started when the last confirmed round was started, the leader has a lease until the minimum election timeout minus the lease drift
+    Clock _lease_clock;
+    // Rank of the leader of the current term for a follower (0 if it is not known)
+    size_t _leader_rank;
+    // Clock started when the follower received the last message of the leader of the current term (only the leader resets it, not the vote requests)
+    Clock _leader_message_clock;
+    // Last commit index of the leader that the follower has committed, and clock started when it was received (used for the stale reads)
+    int _leader_commit_index;
+    Clock _leader_commit_clock;
+
+    // Entries of a client forwarded by the follower to the leader, waiting for the response of the leader
+    struct ForwardedEntries
+    {
+        size_t _client_rank;
+        int _request_id;
+        // Leader to which the entries were forwarded and its term, they are denied if the leader or the term changes before the leader answers
+        // (the leader answers once the entries are applied, so there is no timeout : the clients send them again to the same follower meanwhile)
+        size_t _leader_rank;
+        int _term;
+    };
+    // Forwarded entries by the request id sent to the leader (the request ids of the clients may be the same)
+    std::map<int, ForwardedEntries> _forwarded_entries;
+    // Request id of the next entries forwarded to the leader
+    int _next_forward_id;
 };
\ No newline at end of file
@@ -0,0 +1,50 @@
+#pragma once
+
+// ========== ServerConfig struct ==========
+
+// Options of the servers, given with the arguments of the program (see main.cpp)
+struct ServerConfig
+{
+    // Maximum number of entries sent to a follower and not acknowledged yet (pipelined replication)
+    // If it is set to 0, the pipelined replication is disabled and the leader sends all the entries that are not acknowledged on each heartbeat
+    int pipeline_window = 0;
+
+    // If true, the new entries are sent to the followers as soon as they are received, without waiting for the heartbeat
+    // (the heartbeat is then only used to make sure that the followers don't start an election)
+    bool eager_replication = false;
+    // Time (in microseconds) during which the new entries are gathered before being sent to the followers, to send them in a single request
+    // Used by the eager replication and the pipelined replication (which is also sending the new entries without waiting for the heartbeat)
+    int batch_window = 0;
+
+    // Time (in milliseconds) between two syncs of the write-ahead log of the server
+    // If it is set to 0, the write-ahead log is synced each time new entries are written in it, before they are acknowledged
+    int wal_sync_interval = 0;
+    // Maximum size (in bytes) of a segment of the write-ahead log, a new segment is started once it is reached
+    int segment_size = 1 << 20;
+    // Number of applied entries after which a snapshot of the state of the server is taken, to remove them from the logs
+    // If it is set to 0, no snapshot is taken and the logs are never compacted
+    int snapshot_threshold = 0;
+    // Size (in bytes) of the chunks of the state sent to a follower with a snapshot (a single chunk is sent at a time to each follower)
+    int snapshot_chunk_size = 64 * 1024;
+    // If true, the leader answers the reads directly while it has a lease, instead of confirming its leadership for each round of reads
+    // The lease lasts the minimum election timeout minus the lease drift (in milliseconds) since the last round of heartbeats confirmed by the majority
+    bool lease_read = false;
+    int lease_drift = 20;
+    // If true, the followers also answer the reads of the clients, once they applied the commit index of the leader confirming its leadership
+    // The stale reads are answered directly by a follower that heard from the leader less than the maximum staleness (in milliseconds) ago
+    bool follower_reads = false;
+    int max_staleness = 100;
+    // If true, the followers forward the entries of the clients to the leader they know instead of denying them
+    // The leader answers the follower, which sends the response back to the client
+    bool forward_proposals = false;
+    // If true, the server (and the clients) wait for the messages by probing them again without sleeping, to lower the latency
+    // Otherwise, they sleep the poll interval (in microseconds) between two probes, as MPI can not block until a message comes or a timeout is over
+    bool busy_poll = false;
+    int poll_interval = 50;
+    // Maximum number of messages received by the server (and the clients) in an update, the other ones are received by the next update
+    int receive_budget = 1024;
+    // If true, the committed entries are applied to a key-value store instead of being written in the log file of the server
+    bool kv_store = false;
+    // If true, the server restores its logs from its write-ahead log when it starts (instead of starting with empty logs)
+    bool restore = false;
+};
@@ -0,0 +1,128 @@
+#include "key_value_state_machine.hpp"
+
+#include <cstdint>
+#include <fstream>
+
+#include "rpc/codec/binary_codec.hpp"
+
+// Size of the buffer written in the snapshot file at once
+static const size_t SNAPSHOT_BUFFER_SIZE = 64 * 1024;
+
+// Function used to read the next word of the command (the command is then moved after the word and the following space)
+static std::string_view next_word(std::string_view& command)
+{
+    const size_t end = command.find(' ');
+    const std::string_view word = command.substr(0, end);
+    command = end == std::string_view::npos ? std::string_view() : command.substr(end + 1);
+    return word;
+}
+
+// Function used to read a string of the snapshot file (uint32 length followed by the bytes)
+static bool read_string(std::ifstream& file, std::string& value)
+{
+    uint32_t length = 0;
+    if (!file.read((char*)&length, sizeof(uint32_t)))
+    {
+        return false;
+    }
+    value.resize(length);
+    return (bool)file.read(value.data(), length);
+}
+
+// ========== KeyValueStateMachine class implementation ==========
+
+KeyValueStateMachine::KeyValueStateMachine()
+    : _table()
+{}
+
+void KeyValueStateMachine::apply(const std::vector<LogEntryView>& entries, std::vector<std::string>& results)
+{
+    for (const LogEntryView& entry : entries)
+    {
+        results.push_back(this->apply_command(entry._command));
+    }
+}
+
+std::string KeyValueStateMachine::apply_command(std::string_view command)
+{
+    const std::string_view operation = next_word(command);
+    const std::string_view key = next_word(command);
+    if (key.empty())
+    {
+        return "INVALID";
+    }
+
+    if (operation == "PUT")
+    {
+        this->_table.insert(key, command);
+        return "OK";
+    }
+    if (operation == "GET" && command.empty())
+    {
+        return this->get(key);
+    }
+    if (operation == "DELETE" && command.empty())
+    {
+        return this->_table.erase(key) ? "OK" : "NOT_FOUND";
+    }
+    return "INVALID";
+}
+
+std::string KeyValueStateMachine::read(std::string_view query) const
+{
+    const std::string_view operation = next_word(query);
+    const std::string_view key = next_word(query);
+    return operation == "GET" && !key.empty() && query.empty() ? this->get(key) : "INVALID";
+}
+
+std::string KeyValueStateMachine::get(std::string_view key) const
+{
+    const std::string* value = this->_table.find(key);
+    return value != nullptr ? *value : "NOT_FOUND";
+}
+
+bool KeyValueStateMachine::snapshot(const std::string& filepath)
+{
+    std::ofstream file(filepath, std::ios::binary | std::ios::trunc);
+
+    // The keys are encoded in a buffer which is written in the file each time it is full
+    std::string buffer;
+    BinaryWriter writer = BinaryWriter(buffer);
+    writer.write_uint32(this->_table.size());
+    this->_table.for_each([&](const std::string& key, const std::string& value)
+    {
+        writer.write_string(key);
+        writer.write_string(value);
+        if (buffer.size() >= SNAPSHOT_BUFFER_SIZE)
+        {
+            file.write(buffer.data(), buffer.size());
+            buffer.clear();
+        }
+    });
+    file.write(buffer.data(), buffer.size());
+    file.flush();
+    return file.good();
+}
+
+bool KeyValueStateMachine::restore(const std::string& filepath)
+{
+    std::ifstream file(filepath, std::ios::binary);
+    uint32_t keys_count = 0;
+    if (!file.read((char*)&keys_count, sizeof(uint32_t)))
+    {
+        return false;
+    }
+
+    this->_table.clear();
+    std::string key;
+    std::string value;
+    for (uint32_t i = 0; i < keys_count; i++)
+    {
+        if (!read_string(file, key) || !read_string(file, value))
+        {
+            return false;
+        }
+        this->_table.insert(key, value);
+    }
+    return true;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "state_machine/key_value_table.hpp"
+#include "state_machine/state_machine.hpp"
+
+// ========== KeyValueStateMachine class ==========
+
+// In-memory key-value store, whose keys and values are strings
+// The commands of the entries are :
+//  - PUT {key} {value} : sets the value of the key (the value is the end of the command, and can contain spaces), the result is OK
+//  - GET {key}         : the result is the value of the key, or NOT_FOUND
+//  - DELETE {key}      : removes the key, the result is OK or NOT_FOUND
+// Any other command does not change the state and its result is INVALID
+//
+// The snapshot file has the following binary format (written in the byte order of the host, as the RPCs) :
+//  - uint32 : number of keys
+//  - for each key : the key and its value (uint32 length followed by the bytes)
+class KeyValueStateMachine : public StateMachine
+{
+public:
+    KeyValueStateMachine();
+
+    void apply(const std::vector<LogEntryView>& entries, std::vector<std::string>& results) override;
+    // The only query that can be read is GET {key}
+    std::string read(std::string_view query) const override;
+
+    // The keys are written and read by chunks, so the file is never held in memory as a whole
+    bool snapshot(const std::string& filepath) override;
+    bool restore(const std::string& filepath) override;
+
+private:
+    // Function used to apply a single command and to get its result
+    std::string apply_command(std::string_view command);
+    // Function used to get the result of a GET command
+    std::string get(std::string_view key) const;
+
+    // Keys and values of the store
+    KeyValueTable _table;
+};
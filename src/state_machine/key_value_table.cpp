@@ -0,0 +1,108 @@
+#include "key_value_table.hpp"
+
+#include <functional>
+#include <utility>
+
+// ========== KeyValueTable class implementation ==========
+
+KeyValueTable::KeyValueTable()
+    : _slots(INITIAL_CAPACITY), _size(0), _used_slots(0)
+{}
+
+size_t KeyValueTable::probe(std::string_view key, size_t hash) const
+{
+    const size_t mask = this->_slots.size() - 1;
+    size_t position = hash & mask;
+    while (true)
+    {
+        const Slot& slot = this->_slots[position];
+        if (slot._state == SLOT_STATE::EMPTY || (slot._state == SLOT_STATE::FULL && slot._hash == hash && slot._key == key))
+        {
+            return position;
+        }
+        position = (position + 1) & mask;
+    }
+}
+
+const std::string* KeyValueTable::find(std::string_view key) const
+{
+    const Slot& slot = this->_slots[this->probe(key, std::hash<std::string_view>()(key))];
+    return slot._state == SLOT_STATE::FULL ? &slot._value : nullptr;
+}
+
+void KeyValueTable::insert(std::string_view key, std::string_view value)
+{
+    const size_t hash = std::hash<std::string_view>()(key);
+    size_t position = this->probe(key, hash);
+    if (this->_slots[position]._state == SLOT_STATE::FULL)
+    {
+        this->_slots[position]._value.assign(value);
+        return;
+    }
+
+    // The table is rehashed before adding a key if it is too full (it is only made bigger if the tombstones are not enough to free slots)
+    if ((double)(this->_used_slots + 1) > MAX_LOAD_FACTOR * this->_slots.size())
+    {
+        const bool mostly_keys = (double)(this->_size + 1) > MAX_LOAD_FACTOR * this->_slots.size() / 2;
+        this->rehash(mostly_keys ? this->_slots.size() * 2 : this->_slots.size());
+        position = this->probe(key, hash);
+    }
+
+    Slot& slot = this->_slots[position];
+    slot._state = SLOT_STATE::FULL;
+    slot._hash = hash;
+    slot._key.assign(key);
+    slot._value.assign(value);
+    this->_size++;
+    this->_used_slots++;
+}
+
+bool KeyValueTable::erase(std::string_view key)
+{
+    Slot& slot = this->_slots[this->probe(key, std::hash<std::string_view>()(key))];
+    if (slot._state != SLOT_STATE::FULL)
+    {
+        return false;
+    }
+    // The slot is kept as a tombstone (the used slots do not change), and its strings are freed
+    slot._state = SLOT_STATE::DELETED;
+    std::string().swap(slot._key);
+    std::string().swap(slot._value);
+    this->_size--;
+    return true;
+}
+
+void KeyValueTable::clear()
+{
+    this->_slots = std::vector<Slot>(INITIAL_CAPACITY);
+    this->_size = 0;
+    this->_used_slots = 0;
+}
+
+size_t KeyValueTable::size() const
+{
+    return this->_size;
+}
+
+void KeyValueTable::rehash(size_t capacity)
+{
+    std::vector<Slot> old_slots(capacity);
+    old_slots.swap(this->_slots);
+    this->_used_slots = this->_size;
+
+    // The strings are moved in the new slots, so they are not copied
+    const size_t mask = capacity - 1;
+    for (Slot& old_slot : old_slots)
+    {
+        if (old_slot._state != SLOT_STATE::FULL)
+        {
+            continue;
+        }
+        size_t position = old_slot._hash & mask;
+        while (this->_slots[position]._state != SLOT_STATE::EMPTY)
+        {
+            position = (position + 1) & mask;
+        }
+        this->_slots[position] = std::move(old_slot);
+    }
+}
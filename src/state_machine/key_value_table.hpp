@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// ========== KeyValueTable class ==========
+
+// Hash table of the key-value store, with open addressing and linear probing
+// The slots are kept in a single vector, so a lookup only reads the following slots instead of following the nodes of a list
+// A removed entry leaves a tombstone in its slot, so the entries after it can still be found, and the tombstones are removed when the table is rehashed
+class KeyValueTable
+{
+public:
+    // Initial number of slots (always a power of two), and maximum load of the table (with the tombstones) before it is rehashed
+    static const size_t INITIAL_CAPACITY = 16;
+    static constexpr double MAX_LOAD_FACTOR = 0.7;
+
+    KeyValueTable();
+
+    // Function used to get the value of the given key (nullptr if the key is not in the table)
+    const std::string* find(std::string_view key) const;
+    // Function used to add the given key or to replace its value
+    void insert(std::string_view key, std::string_view value);
+    // Function used to remove the given key (returns false if the key was not in the table)
+    bool erase(std::string_view key);
+    // Function used to remove all the keys
+    void clear();
+
+    // Number of keys in the table
+    size_t size() const;
+
+    // Function used to call the given function with each key and its value (in the order of the slots)
+    template <typename Function>
+    void for_each(Function function) const
+    {
+        for (const Slot& slot : this->_slots)
+        {
+            if (slot._state == SLOT_STATE::FULL)
+            {
+                function(slot._key, slot._value);
+            }
+        }
+    }
+
+private:
+    enum class SLOT_STATE : uint8_t
+    {
+        EMPTY,
+        FULL,
+        DELETED
+    };
+
+    struct Slot
+    {
+        SLOT_STATE _state = SLOT_STATE::EMPTY;
+        // Hash of the key, compared before the key itself
+        size_t _hash = 0;
+        std::string _key;
+        std::string _value;
+    };
+
+    // Position of the slot of the given key, or of the first empty slot of its probing sequence if it is not in the table
+    size_t probe(std::string_view key, size_t hash) const;
+    // Function used to move all the entries in a table of the given capacity (without the tombstones)
+    void rehash(size_t capacity);
+
+    // Slots of the table (the number of slots is a power of two, so the position of a hash is found with a mask)
+    std::vector<Slot> _slots;
+    // Number of keys, and number of slots that are not empty (keys and tombstones)
+    size_t _size;
+    size_t _used_slots;
+};
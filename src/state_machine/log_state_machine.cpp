@@ -0,0 +1,66 @@
+#include "log_state_machine.hpp"
+
+#include <algorithm>
+#include <filesystem>
+#include <iostream>
+
+// ========== LogStateMachine class implementation ==========
+
+LogStateMachine::LogStateMachine(const std::string& log_filepath)
+    : _log_filepath(log_filepath), _lines_count(0)
+{
+    this->_log_file.open(this->_log_filepath);
+    if (!this->_log_file.good())
+    {
+        std::cerr << "Unable to open server logs file !" << std::endl;
+    }
+}
+
+void LogStateMachine::apply(const std::vector<LogEntryView>& entries, std::vector<std::string>& results)
+{
+    for (const LogEntryView& entry : entries)
+    {
+        if (!entry._command.empty())
+        {
+            this->_log_file << entry._command << '\n';
+            this->_lines_count++;
+        }
+        results.emplace_back();
+    }
+
+    this->_log_file.flush();
+    if (!this->_log_file.good())
+    {
+        std::cerr << "Unable to write in file : " << this->_log_filepath << std::endl;
+    }
+}
+
+std::string LogStateMachine::read(std::string_view query) const
+{
+    return query == "COUNT" ? std::to_string(this->_lines_count) : "INVALID";
+}
+
+bool LogStateMachine::snapshot(const std::string& filepath)
+{
+    this->_log_file.flush();
+    std::error_code error;
+    return std::filesystem::copy_file(this->_log_filepath, filepath, std::filesystem::copy_options::overwrite_existing, error);
+}
+
+bool LogStateMachine::restore(const std::string& filepath)
+{
+    this->_log_file.close();
+    std::error_code error;
+    const bool restored = std::filesystem::copy_file(filepath, this->_log_filepath, std::filesystem::copy_options::overwrite_existing, error);
+    this->_log_file.open(this->_log_filepath, std::ofstream::app);
+
+    // Counting the lines of the restored file (it is read by chunks)
+    std::ifstream restored_file(this->_log_filepath, std::ios::binary);
+    std::string buffer(64 * 1024, '\0');
+    this->_lines_count = 0;
+    while (restored_file.read(buffer.data(), buffer.size()) || restored_file.gcount() > 0)
+    {
+        this->_lines_count += std::count(buffer.begin(), buffer.begin() + restored_file.gcount(), '\n');
+    }
+    return restored;
+}
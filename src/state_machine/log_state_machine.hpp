@@ -0,0 +1,34 @@
+#pragma once
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+#include "state_machine/state_machine.hpp"
+
+// ========== LogStateMachine class ==========
+
+// State machine writing the command of each applied entry as a line of the log file of the server
+// The state is the content of the log file, so the log files of all the servers are the same
+// The only query that can be read is COUNT, whose result is the number of lines of the log file
+class LogStateMachine : public StateMachine
+{
+public:
+    // The log file is created empty (it is filled again by the restored snapshot and entries)
+    LogStateMachine(const std::string& log_filepath);
+
+    // The commands are written in the file, which is flushed once per batch (the result of the commands is empty)
+    void apply(const std::vector<LogEntryView>& entries, std::vector<std::string>& results) override;
+    std::string read(std::string_view query) const override;
+
+    // The state is a copy of the log file
+    bool snapshot(const std::string& filepath) override;
+    bool restore(const std::string& filepath) override;
+
+private:
+    // Filepath of the log file, and the log file (kept opened to write the applied entries)
+    std::string _log_filepath;
+    std::ofstream _log_file;
+    // Number of lines of the log file
+    size_t _lines_count;
+};
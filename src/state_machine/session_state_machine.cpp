@@ -0,0 +1,214 @@
+#include "session_state_machine.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+
+#include "rpc/codec/binary_codec.hpp"
+
+// Size of the buffer used to copy the state of the other state machine in the snapshot file
+static const size_t SNAPSHOT_BUFFER_SIZE = 64 * 1024;
+
+// Function used to copy the end of a file in another one (by chunks)
+static bool copy_file_content(std::ifstream& source, std::ofstream& destination)
+{
+    std::string buffer(SNAPSHOT_BUFFER_SIZE, '\0');
+    while (source.read(buffer.data(), buffer.size()) || source.gcount() > 0)
+    {
+        destination.write(buffer.data(), source.gcount());
+    }
+    destination.flush();
+    return destination.good();
+}
+
+// Functions used to read the fields of the sessions in the snapshot file
+static bool read_int32(std::ifstream& file, int32_t& value)
+{
+    return (bool)file.read((char*)&value, sizeof(int32_t));
+}
+
+static bool read_string(std::ifstream& file, std::string& value)
+{
+    uint32_t length = 0;
+    if (!file.read((char*)&length, sizeof(uint32_t)))
+    {
+        return false;
+    }
+    value.resize(length);
+    return (bool)file.read(value.data(), length);
+}
+
+// ========== SessionStateMachine class implementation ==========
+
+SessionStateMachine::SessionStateMachine(std::unique_ptr<StateMachine> state_machine)
+    : _state_machine(std::move(state_machine)), _sessions()
+{}
+
+void SessionStateMachine::apply(const std::vector<LogEntryView>& entries, std::vector<std::string>& results)
+{
+    // Position of each entry in the entries applied to the other state machine (-1 if it is a duplicate)
+    std::vector<LogEntryView> applied_entries;
+    applied_entries.reserve(entries.size());
+    std::vector<int> positions;
+    positions.reserve(entries.size());
+    for (const LogEntryView& entry : entries)
+    {
+        if (entry._client_id == 0)
+        {
+            positions.push_back(applied_entries.size());
+            applied_entries.push_back(entry);
+            continue;
+        }
+
+        // Removing the results that the client already received
+        ClientSession& session = this->_sessions[entry._client_id];
+        if (entry._answered_sequence > session._answered_sequence)
+        {
+            session._results.erase(session._results.begin(), session._results.lower_bound(entry._answered_sequence));
+            session._answered_sequence = entry._answered_sequence;
+        }
+
+        // The result is added to the session once the entry is applied, so the copies applied in the same batch are found
+        if (entry._sequence < session._answered_sequence || !session._results.emplace(entry._sequence, std::string()).second)
+        {
+            positions.push_back(-1);
+        }
+        else
+        {
+            positions.push_back(applied_entries.size());
+            applied_entries.push_back(entry);
+        }
+    }
+
+    std::vector<std::string> applied_results;
+    applied_results.reserve(applied_entries.size());
+    this->_state_machine->apply(applied_entries, applied_results);
+
+    for (size_t i = 0; i < entries.size(); i++)
+    {
+        const LogEntryView& entry = entries.at(i);
+        auto session = this->_sessions.find(entry._client_id);
+        if (positions.at(i) >= 0)
+        {
+            // The result may have been removed meanwhile, if a following entry of the batch says that it was answered
+            if (session != this->_sessions.end())
+            {
+                auto result = session->second._results.find(entry._sequence);
+                if (result != session->second._results.end())
+                {
+                    result->second = applied_results.at(positions.at(i));
+                }
+            }
+            results.push_back(std::move(applied_results.at(positions.at(i))));
+        }
+        else
+        {
+            auto result = session->second._results.find(entry._sequence);
+            results.push_back(result != session->second._results.end() ? result->second : std::string());
+        }
+    }
+}
+
+std::string SessionStateMachine::read(std::string_view query) const
+{
+    return this->_state_machine->read(query);
+}
+
+bool SessionStateMachine::applied_results(int client_id, int first_sequence, size_t count, std::vector<std::string>& results) const
+{
+    auto session = this->_sessions.find(client_id);
+    if (session == this->_sessions.end())
+    {
+        return false;
+    }
+    results.clear();
+    for (int sequence = first_sequence; sequence < first_sequence + (int)count; sequence++)
+    {
+        auto result = session->second._results.find(sequence);
+        if (result != session->second._results.end())
+        {
+            results.push_back(result->second);
+        }
+        else if (sequence < session->second._answered_sequence)
+        {
+            results.push_back(std::string());
+        }
+        else
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool SessionStateMachine::snapshot(const std::string& filepath)
+{
+    const std::string state_filepath = filepath + ".state";
+    if (!this->_state_machine->snapshot(state_filepath))
+    {
+        return false;
+    }
+
+    std::string buffer;
+    BinaryWriter writer = BinaryWriter(buffer);
+    writer.write_uint32(this->_sessions.size());
+    for (const auto& [client_id, session] : this->_sessions)
+    {
+        writer.write_int32(client_id);
+        writer.write_int32(session._answered_sequence);
+        writer.write_uint32(session._results.size());
+        for (const auto& [sequence, result] : session._results)
+        {
+            writer.write_int32(sequence);
+            writer.write_string(result);
+        }
+    }
+
+    std::ofstream file(filepath, std::ios::binary | std::ios::trunc);
+    file.write(buffer.data(), buffer.size());
+    std::ifstream state_file(state_filepath, std::ios::binary);
+    const bool written = copy_file_content(state_file, file);
+    std::remove(state_filepath.c_str());
+    return written;
+}
+
+bool SessionStateMachine::restore(const std::string& filepath)
+{
+    std::ifstream file(filepath, std::ios::binary);
+    uint32_t sessions_count = 0;
+    if (!file.read((char*)&sessions_count, sizeof(uint32_t)))
+    {
+        return false;
+    }
+
+    this->_sessions.clear();
+    for (uint32_t i = 0; i < sessions_count; i++)
+    {
+        int32_t client_id = 0;
+        ClientSession session = ClientSession{0, {}};
+        uint32_t results_count = 0;
+        if (!read_int32(file, client_id) || !read_int32(file, session._answered_sequence)
+            || !file.read((char*)&results_count, sizeof(uint32_t)))
+        {
+            return false;
+        }
+        for (uint32_t j = 0; j < results_count; j++)
+        {
+            int32_t sequence = 0;
+            std::string result;
+            if (!read_int32(file, sequence) || !read_string(file, result))
+            {
+                return false;
+            }
+            session._results.emplace(sequence, std::move(result));
+        }
+        this->_sessions.emplace(client_id, std::move(session));
+    }
+
+    // The end of the file is the state of the other state machine
+    const std::string state_filepath = filepath + ".state";
+    std::ofstream state_file(state_filepath, std::ios::binary | std::ios::trunc);
+    const bool restored = copy_file_content(file, state_file) && this->_state_machine->restore(state_filepath);
+    std::remove(state_filepath.c_str());
+    return restored;
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "state_machine/state_machine.hpp"
+
+// ========== SessionStateMachine class ==========
+
+// State machine applying the entries of the clients to another state machine at most once, even if a client sent them several times
+// Each client has a session with the sequence numbers of its entries : the result of each applied entry is kept in the session,
+// and an entry whose sequence number was already applied is not applied again, its result is the kept one
+// The entries carry the sequence number until which all the entries of their client were answered, the results before it are removed
+// (an entry before it that is applied again is a late copy, the client does not wait for its result anymore so it is empty)
+//
+// The sessions are in the snapshots, before the state of the other state machine, with the following binary format :
+//  - uint32 : number of sessions
+//  - for each session : int32 client id, int32 answered sequence, uint32 number of results,
+//                       and for each result its int32 sequence and the result (uint32 length followed by the bytes)
+//  - the snapshot of the other state machine, until the end of the file
+class SessionStateMachine : public StateMachine
+{
+public:
+    SessionStateMachine(std::unique_ptr<StateMachine> state_machine);
+
+    // The entries that are not duplicates are applied to the other state machine in a single batch
+    void apply(const std::vector<LogEntryView>& entries, std::vector<std::string>& results) override;
+    std::string read(std::string_view query) const override;
+    // Function used to get the results of consecutive entries of a client, from the given sequence number, if they are all applied
+    // (the results of the entries that the client already received are empty, as they are removed from the session)
+    bool applied_results(int client_id, int first_sequence, size_t count, std::vector<std::string>& results) const;
+
+    // The other state machine writes its state in a temporary file, which is copied after the sessions by chunks
+    bool snapshot(const std::string& filepath) override;
+    bool restore(const std::string& filepath) override;
+
+private:
+    // Session of a client : the results of its applied entries that may not be answered yet, by sequence number
+    struct ClientSession
+    {
+        int _answered_sequence;
+        std::map<int, std::string> _results;
+    };
+
+    // State machine to which the entries are applied
+    std::unique_ptr<StateMachine> _state_machine;
+    // Sessions of the clients, by client id (the clients are never removed, as their number is fixed)
+    std::map<int, ClientSession> _sessions;
+};
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "rpc/entries/log_entry.hpp"
+
+// ========== StateMachine class ==========
+
+// State machine replicated by the servers, to which the committed entries of the logs are applied in order
+// All the servers apply the same entries in the same order, so they all have the same state
+// The entries with an empty command are no-op entries of the leaders (see ReadIndex in the server), they must not change the state
+class StateMachine
+{
+public:
+    virtual ~StateMachine() = default;
+
+    // Function used to apply a batch of committed entries, in the order of the logs
+    // The result of each command is added to results (the leader sends it to the client of the entry)
+    virtual void apply(const std::vector<LogEntryView>& entries, std::vector<std::string>& results) = 0;
+    // Function used to answer a query of a client without changing the state (the query is not added to the logs)
+    virtual std::string read(std::string_view query) const = 0;
+
+    // Function used to write the whole state in the given file (used as the state of the snapshots)
+    virtual bool snapshot(const std::string& filepath) = 0;
+    // Function used to replace the whole state by the one written in the given file by snapshot
+    virtual bool restore(const std::string& filepath) = 0;
+};